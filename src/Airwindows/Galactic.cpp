@@ -94,6 +94,12 @@ Galactic::Galactic (const double rate, const float replace, const float brightne
 	//this is reset: values being initialized only once. Startup values, whatever they are.
 }
 
+void Galactic::seed (const uint32_t value)
+{
+	fpdL = value | 0x10000;
+	fpdR = (value * 1664525u + 1013904223u) | 0x10000;
+}
+
 void Galactic::process (const float* input1, const float* input2, float* output1, float* output2, int32_t sampleFrames)
 {
 	double overallscale = 1.0;
@@ -46,6 +46,7 @@ public:
 	void process (const float* input1, const float* input2, float* output1, float* output2, int32_t sampleFrames);
 	float getParameter (size_t index);                   // get the parameter value at the specified index
 	void setParameter (size_t index, float value);       // set the parameter at index to value
+	void seed (const uint32_t value);                    // seed the dither / denormal noise
 
 private:
 	double iirAL;
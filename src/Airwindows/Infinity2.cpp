@@ -83,6 +83,12 @@ Infinity2::Infinity2 (const double rate, const float filter, const float size, c
 	//this is reset: values being initialized only once. Startup values, whatever they are.
 }
 
+void Infinity2::seed (const uint32_t value)
+{
+	fpdL = value | 0x10000;
+	fpdR = (value * 1664525u + 1013904223u) | 0x10000;
+}
+
 void Infinity2::process (const float* input1, const float* input2, float* output1, float* output2, int32_t sampleFrames)
 {
 	const double filter = params[0];
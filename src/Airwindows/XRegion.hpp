@@ -35,6 +35,8 @@
 #include <cmath>
 
 
+#define XREGION_STAGES 5
+
 class XRegion
 {
 public:
@@ -45,15 +47,34 @@ public:
 
     void process (float* input1, float* input2, float* output1, float* output2, int32_t sampleFrames);
 	float* getParameters ();
-    void setParameters (const float* values);
+    void setParameters (const float* values);                      // set parameters and coefficients at once
+    void setParameters (const float* values, const int32_t frames); // ramp the coefficients within frames
+    void seed (const uint32_t value);                    // seed the dither / denormal noise
 
 private:
+    // Coefficients of the five distortion / biquad stages (high, high-mid,
+    // mid, mid-low, low) and the output
+    struct Coefficients
+    {
+        float gain;
+        float wet;
+        float pan;
+        float stageWet[XREGION_STAGES];
+        float clipFactor[XREGION_STAGES];
+        float invCompensation[XREGION_STAGES];
+        float a0[XREGION_STAGES];
+        float b1[XREGION_STAGES];
+        float b2[XREGION_STAGES];
+    };
+
+    Coefficients calculateCoefficients (const float* values) const;
+
     double rate;
-    float biquad[15];
-	float biquadA[15];
-	float biquadB[15];
-	float biquadC[15];
-	float biquadD[15];
+    float stateL[XREGION_STAGES][4];
+    float stateR[XREGION_STAGES][4];
+    Coefficients coeffs;
+    Coefficients deltas;
+    int32_t rampFrames;
 	uint32_t fpdL;
 	uint32_t fpdR;
     float params[6];
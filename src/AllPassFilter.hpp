@@ -21,25 +21,28 @@
 #ifndef ALLPASSFILTER_HPP_
 #define ALLPASSFILTER_HPP_
 
+#include "Stereo.hpp"
+
+/*
+ * First order stereo all pass. The coefficient is passed to process() to
+ * allow sharing it between a chain of filters.
+ */
 class AllPassFilter
 {
 public:
-	AllPassFilter() : AllPassFilter (0) {}
-
-	AllPassFilter (const float delay) : f (0), m (0) {setDelay (delay);}
+	AllPassFilter() : m (0, 0) {}
 
-	void setDelay (const float delay) {f = (1 - delay) / (1 + delay);}
+	static float coefficient (const float delay) {return (1 - delay) / (1 + delay);}
 
-	float process (const float input)
+	Stereo process (const Stereo& input, const Stereo& f)
 	{
-		const float r = m  - input * f;
+		const Stereo r = m - input * f;
 		m = input + r * f;
 		return r;
 	}
 
 protected:
-	float f;
-	float m;
+	Stereo m;
 };
 
 #endif /* ALLPASSFILTER_HPP_ */
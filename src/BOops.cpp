@@ -22,6 +22,9 @@
 #include <string>
 #include <stdexcept>
 #include <algorithm>
+#include <ctime>
+#include <thread>
+#include <chrono>
 #include "BOops.hpp"
 #include "ControllerLimits.hpp"
 #include "BUtilities/stof.hpp"
@@ -29,6 +32,7 @@
 #include "getURIs.hpp"
 #include "to_shapes.hpp"
 #include "bool2hstr.hpp"
+#include "DenormalGuard.hpp"
 
 #ifndef SF_FORMAT_MP3
 #ifndef MINIMP3_IMPLEMENTATION
@@ -50,7 +54,8 @@ BOops::BOops (double samplerate, const char* bundle_path, const LV2_Feature* con
 	activated (false),
 	positions {{0.0, -1, 0.0, 0, {samplerate, 120.0f, 1.0f, 0ul, 0.0f, 4.0f}, 1.0, true}, {0.0, -1, 0.0, 0, {0.0, 120.0f, 1.0f, 0ul, 0.0f, 4.0f}, 0.0, true}},
 	transportGateKeys {false},
-	pages {},
+	pages (nullptr),
+	stateSaving (0),
 	pageNr (0),
 	pageMax (0),
 	midiLearn (false),
@@ -62,15 +67,18 @@ BOops::BOops (double samplerate, const char* bundle_path, const LV2_Feature* con
 	new_controllers {NULL}, globalControllers {0},
 	forge (), notify_frame (),
 	sample (NULL), sampleAmp (1.0f),
-	waveform {0}, waveformCounter (0), lastWaveformCounter (0),
-	message (), ui_on(false), scheduleNotifyAllSlots (false),
+	waveform {}, waveformSent {0}, waveformCounter (0), lastWaveformCounter (0),
+	message (), ui_on(false), scheduleNotifyAllSlots (false), scheduleNotifySlot {{false}},
 	scheduleNotifyPageControls {false},
 	scheduleNotifyStatus (false), scheduleResizeBuffers (false), scheduleSetFx {false},
 	scheduleNotifyWaveformToGui (false), scheduleNotifyTransportGateKeys (false),
 	scheduleNotifySamplePathToGui (false),
 	scheduleNotifyMidiLearnedToGui (false),
 	scheduleStateChanged (false),
-	scheduleInit (false)
+	scheduleInit (false),
+	forceMono (false), forceMonoPort (0.0f),
+	interpolation (RESAMPLER_DEFAULT_QUALITY),
+	seed (time (0)), seedCounter (0)
 
 {
 	if (bundle_path) strncpy (pluginPath, bundle_path, 1023);
@@ -104,18 +112,26 @@ BOops::BOops (double samplerate, const char* bundle_path, const LV2_Feature* con
 	slots.fill (Slot (this, FX_NONE, nullptr, nullptr, 16, 1.0f, 0.25 * samplerate));
 
 	// Init pages
-	for (Page& p : pages)
+	pages = newPages ();
+}
+
+Page* BOops::newPages ()
+{
+	Page* newPages = new Page[NR_PAGES];
+	for (Page* p = newPages; p < newPages + NR_PAGES; ++p)
 	{
-		p.controls = {0, 0, 0, 0};
-		for (std::array<Pad, NR_STEPS>& pp : p.pads) pp.fill (Pad());
-		p.shapes.fill (Shape<SHAPE_MAXNODES>());
-		for (std::array<bool, NR_PIANO_KEYS + 1>& pk : p.keys) pk.fill (false);
+		p->controls = {0, 0, 0, 0};
+		for (std::array<Pad, NR_STEPS>& pp : p->pads) pp.fill (Pad());
+		p->shapes.fill (Shape<SHAPE_MAXNODES>());
+		for (std::array<bool, NR_PIANO_KEYS + 1>& pk : p->keys) pk.fill (false);
 	}
+	return newPages;
 }
 
 BOops::~BOops ()
 {
 	if (sample) delete sample;
+	if (pages) delete[] pages;
 }
 
 void BOops::connect_port(uint32_t port, void *data)
@@ -237,6 +253,30 @@ void BOops::activate() {activated = true;}
 
 void BOops::deactivate() {activated = false;}
 
+void BOops::setSeed (const uint32_t value)
+{
+	seed = value;
+	seedCounter = 0;
+}
+
+void BOops::setInterpolation (const int value)
+{
+	interpolation = value;
+	for (Slot& s : slots)
+	{
+		if (s.fx) s.fx->setQuality (value);
+	}
+}
+
+uint32_t BOops::nextSeed ()
+{
+	// SplitMix64 of the instance seed and the counter
+	uint64_t z = (uint64_t (seed) << 32) + (++seedCounter) * 0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return (z ^ (z >> 31)) >> 32;
+}
+
 void BOops::run (uint32_t n_samples)
 {
 	// Check ports
@@ -244,6 +284,9 @@ void BOops::run (uint32_t n_samples)
 
 	for (int i = 0; i < NR_CONTROLLERS; ++i) if (!new_controllers[i]) return;
 
+	// Flush denormals to zero (restored on return)
+	const DenormalGuard denormalGuard;
+
 	// Prepare forge buffer and initialize atom sequence
 	const uint32_t space = notifyPort->atom.size;
 	lv2_atom_forge_set_buffer(&forge, (uint8_t*) notifyPort, space);
@@ -342,7 +385,18 @@ void BOops::run (uint32_t n_samples)
 		}
 	}
 
+	if (interpolation != *new_controllers[INTERPOLATION])
+	{
+		setInterpolation (controllerLimits[INTERPOLATION].validate (*new_controllers[INTERPOLATION]));
+	}
 
+	// Only port changes: The port doesn't override a restored state
+	if (forceMonoPort != *new_controllers[FORCE_MONO])
+	{
+		forceMonoPort = *new_controllers[FORCE_MONO];
+		forceMono = (controllerLimits[FORCE_MONO].validate (forceMonoPort) != 0.0f);
+		scheduleStateChanged = true;
+	}
 
 	// Control and MIDI messages
 	uint32_t last_t = 0;
@@ -357,7 +411,7 @@ void BOops::run (uint32_t n_samples)
 			if (obj->body.otype == urids.bOops_uiOn)
 			{
 				ui_on = true;
-				scheduleNotifyAllSlots = true;
+				scheduleNotifyAllSlotsToGui ();
 				std::fill (scheduleNotifyPageControls, scheduleNotifyPageControls + NR_PAGES, true);
 				std::fill (scheduleNotifyShape, scheduleNotifyShape + NR_SLOTS, true);
 				scheduleNotifyTransportGateKeys = true;
@@ -511,6 +565,7 @@ void BOops::run (uint32_t n_samples)
 						const uint32_t size = (uint32_t) ((oPd->size - sizeof(LV2_Atom_Vector_Body)) / sizeof (Pad));
 						Pad* pad = (Pad*) (&vec->body + 1);
 						for (unsigned int i = 0; (i < size) && (i < NR_STEPS); ++i) pages[pg].pads[slot][i] = pad[i];
+						padsStateFragments[pg][slot].dirty = true;
 						if (pg == pageNr)
 						{
 							for (unsigned int i = 0; (i < size) && (i < NR_STEPS); ++i) slots[slot].setPad (i, pad[i]);
@@ -543,6 +598,7 @@ void BOops::run (uint32_t n_samples)
 						}
 						if (shape != Shape<SHAPE_MAXNODES>()) shape.validateShape();
 						pages[pg].shapes[slot] = shape;
+						shapeStateFragments[pg][slot].dirty = true;
 						if (pg == pageNr) slots[slot].setSlotShape (shape);
 
 						scheduleStateChanged = true;
@@ -554,6 +610,7 @@ void BOops::run (uint32_t n_samples)
 				{
 					const char* kstr = (const char*) (oKy + 1);
 					hstr2bool<std::array<bool, NR_PIANO_KEYS + 1>> (kstr, pages[pg].keys[slot]);
+					keysStateFragments[pg][slot].dirty = true;
 					if (pg == pageNr) slots[slot].setSlotKeys (pages[pg].keys[slot]);
 					scheduleStateChanged = true;
 				}
@@ -602,6 +659,7 @@ void BOops::run (uint32_t n_samples)
 						{
 							Pad* pad = (Pad*) (&vec->body + 1);
 							pages[pg].pads[slot][step] = *pad;
+							padsStateFragments[pg][slot].dirty = true;
 							if (pg == pageNr) slots[slot].setPad (step, *pad);
 							scheduleStateChanged = true;
 						}
@@ -647,6 +705,7 @@ void BOops::run (uint32_t n_samples)
 							slots[slot].shape.appendNode (node);
 						}
 						slots[slot].shape.validateShape();
+						paramShapeStateFragments[slot].dirty = true;
 						scheduleStateChanged = true;
 					}
 				}
@@ -999,13 +1058,13 @@ void BOops::run (uint32_t n_samples)
 	{
 		if (message.isScheduled ()) notifyMessageToGui ();
 		if (scheduleNotifyStatus) notifyStatusToGui ();
-		if (scheduleNotifyAllSlots) notifyAllSlotsToGui();
 		for (int i = 0; i < NR_PAGES; ++i) {if (scheduleNotifyPageControls[i]) notifyPageControls (i);}
 		for (int i = 0; i < NR_SLOTS; ++i) {if (scheduleNotifyShape[i]) notifyShapeToGui (i);}
 		if (scheduleNotifyTransportGateKeys) notifyTransportGateKeysToGui();
 		if (scheduleNotifyWaveformToGui) notifyWaveformToGui (lastWaveformCounter, waveformCounter);
 		if (scheduleNotifySamplePathToGui) notifySamplePathToGui();
 		if (scheduleNotifyMidiLearnedToGui) notifyMidiLearnedToGui ();
+		if (scheduleNotifyAllSlots) notifyAllSlotsToGui();	// Last, may take several cycles
 	}
 	if (scheduleStateChanged) notifyStateChanged();
 	lv2_atom_forge_pop (&forge, &notify_frame);
@@ -1024,12 +1083,35 @@ void BOops::resizeSteps ()
 	}
 }
 
+void BOops::scheduleNotifyAllSlotsToGui ()
+{
+	for (int page = 0; page < NR_PAGES; ++page) std::fill (scheduleNotifySlot[page], scheduleNotifySlot[page] + NR_SLOTS, true);
+	scheduleNotifyAllSlots = true;
+}
+
 void BOops::notifyAllSlotsToGui ()
 {
-	for (int page = 0; page <= pageMax; ++page)
+	// Resync is paced over several cycles: Send not more than
+	// NOTIFY_SLOTS_BUDGET bytes per cycle and never overflow the notify port.
+	// Start with the page shown in the editor, then the playing page.
+	const uint32_t startOffset = forge.offset;
+
+	for (int i = -2; i <= pageMax; ++i)
 	{
+		const int page = (i == -2 ? editorPage : (i == -1 ? pageNr : i));
+		if ((page < 0) || (page > pageMax)) continue;
+
 		for (int slot = 0; slot < NR_SLOTS; ++slot)
 		{
+			if (!scheduleNotifySlot[page][slot]) continue;
+
+			const uint32_t msgSize = 256 + NR_STEPS * sizeof (Pad) + 7 * sizeof (float) * pages[page].shapes[slot].size();
+			if
+			(
+				(forge.offset + msgSize > forge.size) ||
+				((forge.offset - startOffset + msgSize > NOTIFY_SLOTS_BUDGET) && (forge.offset != startOffset))
+			) return;	// Resume in the next cycle
+
 			LV2_Atom_Forge_Frame frame;
 			lv2_atom_forge_frame_time(&forge, 0);
 			forgePads (&forge, &frame, page, slot, NR_STEPS);
@@ -1039,9 +1121,11 @@ void BOops::notifyAllSlotsToGui ()
 			lv2_atom_forge_key(&forge, urids.bOops_keysData);
 			lv2_atom_forge_string (&forge, hstr, strlen (hstr) + 1);
 			lv2_atom_forge_pop(&forge, &frame);
+			scheduleNotifySlot[page][slot] = false;
 		}
 	}
 
+	for (int page = 0; page < NR_PAGES; ++page) std::fill (scheduleNotifySlot[page], scheduleNotifySlot[page] + NR_SLOTS, false);
 	scheduleNotifyAllSlots = false;
 }
 
@@ -1091,40 +1175,66 @@ void BOops::notifyStatusToGui()
 	lv2_atom_forge_int(&forge, editorPage);
 	lv2_atom_forge_key(&forge, urids.bOops_editorSlot);
 	lv2_atom_forge_int(&forge, editorSlot);
+	lv2_atom_forge_key(&forge, urids.bOops_forceMono);
+	lv2_atom_forge_bool(&forge, forceMono);
 	lv2_atom_forge_pop(&forge, &frame);
 
 	scheduleNotifyStatus = false;
 }
 
+void BOops::updateWaveform (const double pos, const float value)
+{
+	// Accumulate min, max and RMS of all samples within a display bin
+	const int bin = int (pos * WAVEFORMSIZE) % WAVEFORMSIZE;
+	if (bin != waveformCounter) waveform[bin].reset (value);
+	else waveform[bin].add (value);
+	waveformCounter = bin;
+}
+
 void BOops::notifyWaveformToGui (const int start, const int end)
 {
-	int p1 = (start <= end ? end : WAVEFORMSIZE - 1);
+	if (start <= end) notifyWaveformRangeToGui (start, end);
+
+	// Position exceeds end
+	else
+	{
+		notifyWaveformRangeToGui (start, WAVEFORMSIZE - 1);
+		notifyWaveformRangeToGui (0, end);
+	}
+
+	scheduleNotifyWaveformToGui = false;
+	lastWaveformCounter = end;
+}
+
+void BOops::notifyWaveformRangeToGui (const int start, const int end)
+{
+	// Pack bins and skip leading and trailing bins unchanged since the last
+	// notification
+	int32_t packed[WAVEFORMSIZE];
+	int first = -1;
+	int last = -1;
+	for (int i = start; i <= end; ++i)
+	{
+		packed[i] = packWaveformBin (waveform[i].get());
+		if (packed[i] != waveformSent[i])
+		{
+			if (first < 0) first = i;
+			last = i;
+		}
+	}
+
+	if (first < 0) return;
 
-	// Notify shapeBuffer (position to end)
 	LV2_Atom_Forge_Frame frame;
 	lv2_atom_forge_frame_time(&forge, 0);
 	lv2_atom_forge_object(&forge, &frame, 0, urids.bOops_waveformEvent);
 	lv2_atom_forge_key(&forge, urids.bOops_waveformStart);
-	lv2_atom_forge_int(&forge, start);
+	lv2_atom_forge_int(&forge, first);
 	lv2_atom_forge_key(&forge, urids.bOops_waveformData);
-	lv2_atom_forge_vector(&forge, sizeof(float), urids.atom_Float, (uint32_t) (p1 + 1 - start), &waveform[start]);
+	lv2_atom_forge_vector(&forge, sizeof(int32_t), urids.atom_Int, (uint32_t) (last + 1 - first), &packed[first]);
 	lv2_atom_forge_pop(&forge, &frame);
 
-	// Additional notification if position exceeds end
-	if (start > waveformCounter)
-	{
-		LV2_Atom_Forge_Frame frame;
-		lv2_atom_forge_frame_time(&forge, 0);
-		lv2_atom_forge_object(&forge, &frame, 0, urids.bOops_waveformEvent);
-		lv2_atom_forge_key(&forge, urids.bOops_waveformStart);
-		lv2_atom_forge_int(&forge, 0);
-		lv2_atom_forge_key(&forge, urids.bOops_waveformData);
-		lv2_atom_forge_vector(&forge, sizeof(float), urids.atom_Float, (uint32_t) (end), &waveform[0]);
-		lv2_atom_forge_pop(&forge, &frame);
-	}
-
-	scheduleNotifyWaveformToGui = false;
-	lastWaveformCounter = end;
+	std::copy (&packed[first], &packed[last + 1], &waveformSent[first]);
 }
 
 void BOops::notifyTransportGateKeysToGui()
@@ -1316,6 +1426,13 @@ Stereo BOops::getSample (const Position& p, const double pos)
 	else return Stereo();
 }
 
+Stereo BOops::getInput (const uint32_t frame) const
+{
+	if (!forceMono) return Stereo (audioInput1[frame], audioInput2[frame]);
+	const float m = 0.5f * (audioInput1[frame] + audioInput2[frame]);
+	return Stereo (m, m);
+}
+
 void BOops::play (uint32_t start, uint32_t end)
 {
 	if (end < start) return;
@@ -1324,7 +1441,7 @@ void BOops::play (uint32_t start, uint32_t end)
 	{
 		for (uint32_t i = start; i < end; ++i)
 		{
-			for (Slot& s : slots) s.buffer->push_front (Stereo {audioInput1[i], audioInput2[i]});
+			for (Slot& s : slots) s.push (getInput (i));
 		}
 		memset(&audioOutput1[start], 0, (end - start) * sizeof(float));
 		memset(&audioOutput2[start], 0, (end - start) * sizeof(float));
@@ -1342,14 +1459,13 @@ void BOops::play (uint32_t start, uint32_t end)
 			double pos = floorfrac (p.sequence + relpos);				// 0..1 position sequence
 
 			// Input signal
-			Stereo input = (globalControllers[SOURCE] == SOURCE_SAMPLE) ? getSample (p, pos) : Stereo (audioInput1[i], audioInput2[i]);
+			Stereo input = (globalControllers[SOURCE] == SOURCE_SAMPLE) ? getSample (p, pos) : getInput (i);
 
 			// Load samples to buffer
-			for (Slot& s : slots) s.buffer->push_front (input);
+			for (Slot& s : slots) s.push (input);
 
 			// Waveform
-			waveformCounter = int (pos * WAVEFORMSIZE) % WAVEFORMSIZE;
-			waveform[waveformCounter] = (input.left + input.right) / 2;
+			updateWaveform (pos, (input.left + input.right) / 2);
 
 			// Bypass to output
 			audioOutput1[i] = input.left;
@@ -1361,45 +1477,99 @@ void BOops::play (uint32_t start, uint32_t end)
 		return;
 	}
 
-	
-	for (uint32_t i = start; i < end; ++i)
+	// Slots only read their own buffer and the output of the previous slot.
+	// Thus they are played one after another over sub-blocks. Except for
+	// FxSurprise, which sets the mix of other slots each frame.
+	uint32_t blockSize = BOOPS_BLOCKSIZE;
+	for (const Slot& s : slots)
+	{
+		if ((s.effect == FX_INVALID) || (s.effect == FX_NONE)) break;
+		if (s.effect == FX_SURPRISE) blockSize = 1;
+	}
+
+	for (uint32_t b0 = start; b0 < end; )
 	{
+		Stereo inputs[BOOPS_BLOCKSIZE];
+		Stereo outputs[BOOPS_BLOCKSIZE];
+		double faders[BOOPS_BLOCKSIZE];
+		double steps[BOOPS_BLOCKSIZE];
+		int iSteps[BOOPS_BLOCKSIZE];
+		int lastSteps[BOOPS_BLOCKSIZE];	// Step before an init, -1 if not set
+		bool playings[BOOPS_BLOCKSIZE];
+		bool inits[BOOPS_BLOCKSIZE];
+		bool scheduledInits[BOOPS_BLOCKSIZE];
+		bool switchPosition = false;
+		uint32_t n = 0;
+
+		// Positions, input and step inits for each frame of the sub-block
 		Position& p = positions[0];
-		p.fader = p.fader + (1.0 - 2.0 * (sizePosition() > 1)) / (FADINGTIME * p.transport.rate);
-		p.fader = LIMIT (p.fader, 0.0, 1.0);
+		const double dsteps = getPositionFromFrames (p.transport, 1) * globalControllers[STEPS];
+		while ((n < blockSize) && (b0 + n < end) && (!switchPosition))
+		{
+			const uint32_t i = b0 + n;
+			p.fader = p.fader + (1.0 - 2.0 * (sizePosition() > 1)) / (FADINGTIME * p.transport.rate);
+			p.fader = LIMIT (p.fader, 0.0, 1.0);
+			faders[n] = p.fader;
+
+			// Interpolate position within the loop
+			double relpos = getPositionFromFrames (p.transport, i - p.refFrame);	// Position relative to reference frame
+			double pos = floorfrac (p.sequence + relpos);							// 0..1 position sequence
 
-		// Interpolate position within the loop
-		double relpos = getPositionFromFrames (p.transport, i - p.refFrame);	// Position relative to reference frame
-		double pos = floorfrac (p.sequence + relpos);							// 0..1 position sequence
+			// Input
+			inputs[n] = (globalControllers[SOURCE] == SOURCE_SAMPLE) ? getSample (p, pos) : getInput (i);
+			outputs[n] = inputs[n];
 
-		// Input
-		const Stereo input = (globalControllers[SOURCE] == SOURCE_SAMPLE) ? getSample (p, pos) : Stereo (audioInput1[i], audioInput2[i]);
-		Stereo output = input;
+			// Waveform
+			updateWaveform (pos, (inputs[n].left + inputs[n].right) / 2);
 
-		// Waveform
-		waveformCounter = int (pos * WAVEFORMSIZE) % WAVEFORMSIZE;
-		waveform[waveformCounter] = (input.left + input.right) / 2;
+			playings[n] =
+			(
+				(p.playing) &&
+				((p.transport.speed != 0.0f) || (globalControllers[BASE] == SECONDS)) &&
+				(p.transport.bpm >= 1.0f)
+			);
 
-		if
-		(
-			(p.playing) &&
-			((p.transport.speed != 0.0f) || (globalControllers[BASE] == SECONDS)) &&
-			(p.transport.bpm >= 1.0f)
-		)
+			inits[n] = false;
+			if (playings[n])
+			{
+				steps[n] = pos * globalControllers[STEPS];
+				iSteps[n] = LIMIT (steps[n], 0, globalControllers[STEPS] - 1);
+
+				// Init step ?
+				if (scheduleInit || (p.step != iSteps[n]))
+				{
+					inits[n] = true;
+					lastSteps[n] = p.step;
+					scheduledInits[n] = scheduleInit;
+					scheduleInit = false;
+				}
+
+				p.step = iSteps[n];
+			}
+
+			// Just faded out ? Switch to new position data after this frame
+			switchPosition = ((p.fader <= 0) && (sizePosition() > 1));
+			++n;
+		}
+
+		// Play slots
+		for (Slot& s : slots)
 		{
-			double step = pos * globalControllers[STEPS];
-			int iStep = LIMIT (step, 0, globalControllers[STEPS] - 1);
+			const bool noFx = ((s.effect == FX_INVALID) || (s.effect == FX_NONE));
 
-			// Init step ?
-			if (scheduleInit || (p.step != iStep))
+			for (uint32_t k = 0; k < n; )
 			{
-				for (Slot& s : slots)
+				if (!playings[k])
 				{
-					if ((s.effect == FX_INVALID) || (s.effect == FX_NONE)) break;
+					++k;
+					continue;
+				}
 
+				if (inits[k] && (!noFx))
+				{
 					// Old pad ended?
-					const int iStart = s.startPos[iStep];
-					if (((p.step < 0) || (s.startPos[p.step] != iStart)) && (s.getMode() == MODE_PATTERN))
+					const int iStart = s.startPos[iSteps[k]];
+					if (((lastSteps[k] < 0) || (s.startPos[lastSteps[k]] != iStart)) && (s.getMode() == MODE_PATTERN))
 					{
 						// Stop old pad
 						s.end ();
@@ -1408,87 +1578,101 @@ void BOops::play (uint32_t start, uint32_t end)
 						if (iStart >= 0) s.init (iStart);
 					}
 
-					else if (scheduleInit)
+					else if (scheduledInits[k])
 					{
 						s.end();
-						s.init (LIMIT (step, 0, globalControllers[STEPS] - 1));
+						s.init (LIMIT (steps[k], 0, globalControllers[STEPS] - 1));
 					}
 				}
-				scheduleInit = false;
-			}
 
-			// Play slots
-			const double dsteps = getPositionFromFrames (p.transport, 1) * globalControllers[STEPS];
-			for (Slot& s : slots)
-			{
-				// Store last output
-				s.buffer->push_front (output);
-
-				if ((s.effect == FX_INVALID) || (s.effect == FX_NONE)) break;
+				// Pattern mode: Play all frames up to the next init at once
+				uint32_t m = k + 1;
+				if ((!noFx) && s.params[SLOTS_PLAY] && (s.getMode() == MODE_PATTERN) && (s.mixf == 1.0f))
+				{
+					while ((m < n) && playings[m] && (!inits[m])) ++m;
+					s.play (&steps[k], &outputs[k], m - k);
+				}
 
-				// Play music :-)
-				if (s.params[SLOTS_PLAY])
+				else
 				{
-					if (s.getMode() == MODE_KEYS)
+					// Store last output
+					s.push (outputs[k]);
+
+					if (noFx)
 					{
-						float mx = 0;
-						for (MidiKey** iit = s.midis.begin(); iit < s.midis.end(); ++iit)
+						++k;
+						continue;
+					}
+
+					// Play music :-)
+					if (s.params[SLOTS_PLAY])
+					{
+						if (s.getMode() == MODE_KEYS)
 						{
-							if (((**iit).status != 0) && s.isKey ((**iit).note)) mx = std::max (float ((**iit).velocity) * float ((**iit).value) / 127.0f, mx);
+							float mx = 0;
+							for (MidiKey** iit = s.midis.begin(); iit < s.midis.end(); ++iit)
+							{
+								if (((**iit).status != 0) && s.isKey ((**iit).note)) mx = std::max (float ((**iit).velocity) * float ((**iit).value) / 127.0f, mx);
+							}
+							outputs[k] = s.play (steps[k], mx);
 						}
-						output = s.play (step, mx);
-					}
 
-					else output = s.play (step);
+						else outputs[k] = s.play (steps[k]);
+					}
 				}
 
-				s.mixf = 1.0f;
-
-				// Update MidiKeys
-				for (MidiKey** iit = s.midis.begin(); iit < s.midis.end(); )
+				for (; k < m; ++k)
 				{
-					// Update position;
-					(**iit).count +=dsteps;
-
-					// Use ADSR envelope
-					double adr = s.params[SLOTS_ATTACK] + s.params[SLOTS_DECAY] + s.params[SLOTS_RELEASE];
-					if (adr < 1.0f) adr = 1.0f;
-					const double a = s.params[SLOTS_ATTACK] / adr;
-					const double d = s.params[SLOTS_DECAY] / adr;
-					const double r = s.params[SLOTS_RELEASE] / adr;
-		
-					// Recalculate value
-					// NOTE_ON
-					if ((**iit).status == 9)
-					{
-						if ((**iit).count < a) (**iit).value = std::min ((**iit).value + dsteps / a, 1.0);
-						else if ((**iit).count < a + d) (**iit).value = std::max ((**iit).value - dsteps / d, double (s.params[SLOTS_SUSTAIN]));
-						else (**iit).value = s.params[SLOTS_SUSTAIN];
-					}
+					s.mixf = 1.0f;
 
-					// NOTE_OFF
-					else if ((**iit).status == 8)
+					// Update MidiKeys
+					for (MidiKey** iit = s.midis.begin(); iit < s.midis.end(); )
 					{
-						if (r == 0) (**iit).value = 0.0;
-						else (**iit).value -= dsteps / r;
-					}
+						// Update position;
+						(**iit).count +=dsteps;
+
+						// Use ADSR envelope
+						double adr = s.params[SLOTS_ATTACK] + s.params[SLOTS_DECAY] + s.params[SLOTS_RELEASE];
+						if (adr < 1.0f) adr = 1.0f;
+						const double a = s.params[SLOTS_ATTACK] / adr;
+						const double d = s.params[SLOTS_DECAY] / adr;
+						const double r = s.params[SLOTS_RELEASE] / adr;
+		
+						// Recalculate value
+						// NOTE_ON
+						if ((**iit).status == 9)
+						{
+							if ((**iit).count < a) (**iit).value = std::min ((**iit).value + dsteps / a, 1.0);
+							else if ((**iit).count < a + d) (**iit).value = std::max ((**iit).value - dsteps / d, double (s.params[SLOTS_SUSTAIN]));
+							else (**iit).value = s.params[SLOTS_SUSTAIN];
+						}
+
+						// NOTE_OFF
+						else if ((**iit).status == 8)
+						{
+							if (r == 0) (**iit).value = 0.0;
+							else (**iit).value -= dsteps / r;
+						}
 
-					else (**iit).value = 0.0;
+						else (**iit).value = 0.0;
 
-					// Cleanup
-					if (((**iit).value <= 0.0) || ((**iit).status == 0)) iit = s.midis.erase (iit);
-					else ++iit;	 
+						// Cleanup
+						if (((**iit).value <= 0.0) || ((**iit).status == 0)) iit = s.midis.erase (iit);
+						else ++iit;	 
+					}
 				}
 			}
 
-			p.step = iStep;
+			if (noFx) break;
+		}
+
+		for (uint32_t k = 0; k < n; ++k)
+		{
+			audioOutput1[b0 + k] = (1.0 - faders[k]) * inputs[k].left + faders[k] * outputs[k].left;
+			audioOutput2[b0 + k] = (1.0 - faders[k]) * inputs[k].right + faders[k] * outputs[k].right;
 		}
-		
-		audioOutput1[i] = (1.0 - p.fader) * input.left + p.fader * output.left;
-		audioOutput2[i] = (1.0 - p.fader) * input.right + p.fader * output.right;
 
-		// Just faded out ?
-		if ((p.fader <= 0) && (sizePosition() > 1))
+		if (switchPosition)
 		{
 			// Switch to new position data to fade in
 			popFrontPosition();
@@ -1503,12 +1687,27 @@ void BOops::play (uint32_t start, uint32_t end)
 
 			scheduleInit = true;
 		}
+
+		b0 += n;
 	}
 }
 
+// Marks a state_save () in progress for its scope. Pages and samples
+// replaced by installState () in the meantime aren't freed until all scopes
+// are left. The fragment getters load pages after clearing the dirty flag,
+// thus they never cache data from replaced pages.
+struct StateSaveScope
+{
+	StateSaveScope (std::atomic<int>& counter) : counter (counter) {++counter;}
+	~StateSaveScope () {--counter;}
+	std::atomic<int>& counter;
+};
+
 LV2_State_Status BOops::state_save (LV2_State_Store_Function store, LV2_State_Handle handle, uint32_t flags,
 			const LV2_Feature* const* features)
 {
+	const StateSaveScope saveScope (stateSaving);
+
 	// Store sample path
 	if (sample && sample->path && (sample->path[0] != 0) && (globalControllers[SOURCE] == SOURCE_SAMPLE))
 	{
@@ -1570,6 +1769,17 @@ LV2_State_Status BOops::state_save (LV2_State_Store_Function store, LV2_State_Ha
 		}
 	}
 
+	// Store seed (also the time based one) to reproduce the session
+	const int64_t sd = seed;
+	store (handle, urids.bOops_seed, &sd, sizeof (sd), urids.atom_Long, LV2_STATE_IS_POD | LV2_STATE_IS_PORTABLE);
+
+	// Store force mono (only if set)
+	if (forceMono)
+	{
+		const int32_t fm = 1;
+		store (handle, urids.bOops_forceMono, &fm, sizeof (fm), urids.atom_Bool, LV2_STATE_IS_POD | LV2_STATE_IS_PORTABLE);
+	}
+
 	// Store transportGateKeys
 	{
 		// Create atom:Vector
@@ -1613,141 +1823,165 @@ LV2_State_Status BOops::state_save (LV2_State_Store_Function store, LV2_State_Ha
 
 	// Store pads
 	{
-		char padDataString[0x8010] = "\nMatrix data:\n";
+		std::string padDataString = "\nMatrix data:\n";
 
 		for (int pgNr = 0; pgNr <= pageMax; ++pgNr)
 		{
 			for (int slotNr = 0; slotNr < NR_SLOTS; ++slotNr)
 			{
 				if ((slots[slotNr].effect == FX_NONE) || (slots[slotNr].effect == FX_INVALID)) continue;
-
-				for (int stepNr = 0; stepNr < NR_STEPS; ++stepNr)
-				{
-					Pad p = pages[pgNr].pads[slotNr][stepNr];
-					if ((p.gate > 0) && (p.size > 0) && (p.mix > 0))
-					{
-						char valueString[64];
-						snprintf (valueString, 62, "pg:%d; sl:%d; st:%d; gt:%1.3f; sz:%d; mx:%1.3f", pgNr, slotNr, stepNr, p.gate, int (p.size), p.mix);
-						if ((slotNr < NR_SLOTS - 1) || (stepNr < NR_STEPS)) strcat (valueString, ";\n");
-						else strcat(valueString, "\n");
-						strcat (padDataString, valueString);
-					}
-
-				}
+				padDataString += getPadsStateFragment (pgNr, slotNr);
 			}
 		}
-		store (handle, urids.bOops_statePad, padDataString, strlen (padDataString) + 1, urids.atom_String, LV2_STATE_IS_POD);
+		store (handle, urids.bOops_statePad, padDataString.c_str(), padDataString.size() + 1, urids.atom_String, LV2_STATE_IS_POD);
 	}
 
 	// Store Keys
 	{
-		char keysDataString[8192] = "";
+		std::string keysDataString = "";
 
 		for (int pageNr = 0; pageNr <= pageMax; ++pageNr)
 		{
-			strcat (keysDataString, "\nKeys data slots page ");
-			char pageString[16];
-			snprintf (pageString, 12, "%d", pageNr);
-			strcat (keysDataString, pageString);
-			strcat (keysDataString, ":\n");
-			for (int slotNr = 0; slotNr < NR_SLOTS; ++slotNr)
-			{
-				if (pages[pageNr].keys[slotNr][NR_PIANO_KEYS])
-				{
-					char slotString[16];
-					snprintf (slotString, 12, "slo: %d", slotNr);
-					char keysString[40];
-					bool2hstr<std::array<bool, NR_PIANO_KEYS + 1>> (pages[pageNr].keys[slotNr], keysString);
-
-					strcat (keysDataString, slotString);
-					strcat (keysDataString, " key: 0x");
-					strcat (keysDataString, keysString);
-					strcat (keysDataString, ";\n");
-				}
-			}
+			keysDataString += "\nKeys data slots page " + std::to_string (pageNr) + ":\n";
+			for (int slotNr = 0; slotNr < NR_SLOTS; ++slotNr) keysDataString += getKeysStateFragment (pageNr, slotNr);
 		}
 
-		store (handle, urids.bOops_keysData, keysDataString, strlen (keysDataString) + 1, urids.atom_String, LV2_STATE_IS_POD);
+		store (handle, urids.bOops_keysData, keysDataString.c_str(), keysDataString.size() + 1, urids.atom_String, LV2_STATE_IS_POD);
 	}
 
 	// Store shapes
 	{
-		char shapesDataString[0x110000] = "";
+		std::string shapesDataString = "";
 
 		// Slot shapes
 		for (int pageNr = 0; pageNr <= pageMax; ++pageNr)
 		{
-			strcat (shapesDataString, "\nShape data slots page ");
-			char pageString[16];
-			snprintf (pageString, 12, "%d", pageNr);
-			strcat (shapesDataString, pageString);
-			strcat (shapesDataString, ":\n");
-			for (int slotNr = 0; slotNr < NR_SLOTS; ++slotNr)
-			{
-				if (pages[pageNr].shapes[slotNr] != Shape<SHAPE_MAXNODES>())
-				{
-					for (unsigned int nodeNr = 0; nodeNr < pages[pageNr].shapes[slotNr].size(); ++nodeNr)
-					{
-						char valueString[160];
-						Node node = pages[pageNr].shapes[slotNr].getNode (nodeNr);
-						snprintf
-						(
-							valueString,
-							126,
-							"slo:%d; typ:%d; ptx:%f; pty:%f; h1x:%f; h1y:%f; h2x:%f; h2y:%f",
-							slotNr,
-							int (node.nodeType),
-							node.point.x,
-							node.point.y,
-							node.handle1.x,
-							node.handle1.y,
-							node.handle2.x,
-							node.handle2.y
-						);
-						if ((slotNr < NR_SLOTS - 1) || (nodeNr < pages[pageNr].shapes[slotNr].size ())) strcat (valueString, ";\n");
-						else strcat(valueString, "\n");
-						strcat (shapesDataString, valueString);
-					}
-				}
-			}
-			strcat(shapesDataString, "\n");
+			shapesDataString += "\nShape data slots page " + std::to_string (pageNr) + ":\n";
+			for (int slotNr = 0; slotNr < NR_SLOTS; ++slotNr) shapesDataString += getShapeStateFragment (pageNr, slotNr);
+			shapesDataString += "\n";
 		}
 
-
 		// Param shapes
-		strcat (shapesDataString, "\nShape data param:\n");
+		shapesDataString += "\nShape data param:\n";
+		for (int slotNr = 0; slotNr < NR_SLOTS; ++slotNr) shapesDataString += getParamShapeStateFragment (slotNr);
+		store (handle, urids.bOops_shapeData, shapesDataString.c_str(), shapesDataString.size() + 1, urids.atom_String, LV2_STATE_IS_POD);
+	}
+
+	return LV2_STATE_SUCCESS;
+}
+
+void BOops::setAllStateFragmentsDirty ()
+{
+	for (int pgNr = 0; pgNr < NR_PAGES; ++pgNr)
+	{
 		for (int slotNr = 0; slotNr < NR_SLOTS; ++slotNr)
 		{
-			if (!slots[slotNr].shape.isDefault())
+			padsStateFragments[pgNr][slotNr].dirty = true;
+			keysStateFragments[pgNr][slotNr].dirty = true;
+			shapeStateFragments[pgNr][slotNr].dirty = true;
+		}
+	}
+
+	for (StateFragment& f : paramShapeStateFragments) f.dirty = true;
+}
+
+const std::string& BOops::getPadsStateFragment (const int page, const int slot)
+{
+	StateFragment& fragment = padsStateFragments[page][slot];
+
+	// Regenerate until not set dirty in the meantime
+	while (fragment.dirty.exchange (false))
+	{
+		const Page* source = pages;
+		fragment.data.clear();
+		for (int stepNr = 0; stepNr < NR_STEPS; ++stepNr)
+		{
+			const Pad& p = source[page].pads[slot][stepNr];
+			if ((p.gate > 0) && (p.size > 0) && (p.mix > 0))
 			{
-				for (unsigned int nodeNr = 0; nodeNr < slots[slotNr].shape.size (); ++nodeNr)
-				{
-					char valueString[160];
-					Node node = slots[slotNr].shape.getNode (nodeNr);
-					snprintf
-					(
-						valueString,
-						126,
-						"slo:%d; typ:%d; ptx:%f; pty:%f; h1x:%f; h1y:%f; h2x:%f; h2y:%f",
-						slotNr,
-						int (node.nodeType),
-						node.point.x,
-						node.point.y,
-						node.handle1.x,
-						node.handle1.y,
-						node.handle2.x,
-						node.handle2.y
-					);
-					if ((slotNr < NR_SLOTS - 1) || (nodeNr < slots[slotNr].shape.size ())) strcat (valueString, ";\n");
-					else strcat(valueString, "\n");
-					strcat (shapesDataString, valueString);
-				}
+				char valueString[64];
+				snprintf (valueString, 62, "pg:%d; sl:%d; st:%d; gt:%1.3f; sz:%d; mx:%1.3f", page, slot, stepNr, p.gate, int (p.size), p.mix);
+				fragment.data += valueString;
+				fragment.data += ";\n";
 			}
 		}
-		store (handle, urids.bOops_shapeData, shapesDataString, strlen (shapesDataString) + 1, urids.atom_String, LV2_STATE_IS_POD);
 	}
 
-	return LV2_STATE_SUCCESS;
+	return fragment.data;
+}
+
+const std::string& BOops::getKeysStateFragment (const int page, const int slot)
+{
+	StateFragment& fragment = keysStateFragments[page][slot];
+
+	// Regenerate until not set dirty in the meantime
+	while (fragment.dirty.exchange (false))
+	{
+		const Page* source = pages;
+		fragment.data.clear();
+		if (source[page].keys[slot][NR_PIANO_KEYS])
+		{
+			char keysString[40];
+			bool2hstr<std::array<bool, NR_PIANO_KEYS + 1>> (source[page].keys[slot], keysString);
+			fragment.data = "slo: " + std::to_string (slot) + " key: 0x" + keysString + ";\n";
+		}
+	}
+
+	return fragment.data;
+}
+
+static void shapeToString (const int slot, const Shape<SHAPE_MAXNODES>& shape, std::string& dest)
+{
+	for (unsigned int nodeNr = 0; nodeNr < shape.size(); ++nodeNr)
+	{
+		char valueString[160];
+		const Node node = shape.getNode (nodeNr);
+		snprintf
+		(
+			valueString,
+			126,
+			"slo:%d; typ:%d; ptx:%f; pty:%f; h1x:%f; h1y:%f; h2x:%f; h2y:%f",
+			slot,
+			int (node.nodeType),
+			node.point.x,
+			node.point.y,
+			node.handle1.x,
+			node.handle1.y,
+			node.handle2.x,
+			node.handle2.y
+		);
+		dest += valueString;
+		dest += ";\n";
+	}
+}
+
+const std::string& BOops::getShapeStateFragment (const int page, const int slot)
+{
+	StateFragment& fragment = shapeStateFragments[page][slot];
+
+	// Regenerate until not set dirty in the meantime
+	while (fragment.dirty.exchange (false))
+	{
+		const Page* source = pages;
+		fragment.data.clear();
+		if (source[page].shapes[slot] != Shape<SHAPE_MAXNODES>()) shapeToString (slot, source[page].shapes[slot], fragment.data);
+	}
+
+	return fragment.data;
+}
+
+const std::string& BOops::getParamShapeStateFragment (const int slot)
+{
+	StateFragment& fragment = paramShapeStateFragments[slot];
+
+	// Regenerate until not set dirty in the meantime
+	while (fragment.dirty.exchange (false))
+	{
+		fragment.data.clear();
+		if (!slots[slot].shape.isDefault()) shapeToString (slot, slots[slot].shape, fragment.data);
+	}
+
+	return fragment.data;
 }
 
 LV2_State_Status BOops::state_restore (LV2_State_Retrieve_Function retrieve, LV2_State_Handle handle, uint32_t flags,
@@ -1795,6 +2029,35 @@ LV2_State_Status BOops::state_restore (LV2_State_Retrieve_Function retrieve, LV2
 		return LV2_STATE_ERR_NO_FEATURE;
 	}
 
+	// Build the new configuration in a separate bundle from the retrieved
+	// data only. The live pages are written by run () in the meantime.
+	StateBundle* state = nullptr;
+	try
+	{
+		state = new StateBundle();
+		state->pages = newPages ();
+	}
+	catch (std::bad_alloc& ba)
+	{
+		fprintf (stderr, "BOops.lv2: Can't allocate enough memory to restore state.\n");
+		if (state) delete state;
+		return LV2_STATE_ERR_UNKNOWN;
+	}
+
+	state->paramShapesRestored = false;
+	std::copy (transportGateKeys, transportGateKeys + NR_PIANO_KEYS, state->transportGateKeys);
+	state->transportGateKeysRestored = false;
+	state->pageNr = 0;
+	state->pageMax = 0;
+	state->editorPage = 0;
+	state->editorSlot = 0;
+	state->sample = nullptr;
+	state->sampleAmp = 1.0f;
+	state->sampleError = false;
+	state->seed = 0;
+	state->seedRestored = false;
+	state->forceMono = false;
+
 	size_t   size;
 	uint32_t type;
 	uint32_t valflags;
@@ -1816,7 +2079,7 @@ LV2_State_Status BOops::state_restore (LV2_State_Retrieve_Function retrieve, LV2
 			else
 			{
 				fprintf (stderr, "BOops.lv2: Sample path too long.\n");
-				message.setMessage (CANT_OPEN_SAMPLE);
+				state->sampleError = true;
 			}
 
 			fprintf(stderr, "BOops.lv2: Restore abs_path:%s\n", absPath);
@@ -1840,52 +2103,38 @@ LV2_State_Status BOops::state_restore (LV2_State_Retrieve_Function retrieve, LV2
 	const void* loopData = retrieve (handle, urids.bOops_sampleLoop, &size, &type, &valflags);
         if (loopData && (type == urids.atom_Bool)) sampleLoop = *(int32_t*)loopData;
 
-	if (activated && schedule)
-	{
-		LV2_Atom_Forge forge;
-		lv2_atom_forge_init(&forge, map);
-		uint8_t buf[1200];
-		lv2_atom_forge_set_buffer(&forge, buf, sizeof(buf));
-		LV2_Atom_Forge_Frame frame;
-		LV2_Atom* msg = (LV2_Atom*)forgeSamplePath (&forge, &frame, samplePath, sampleStart, sampleEnd, sampleAmp, sampleLoop);
-		lv2_atom_forge_pop(&forge, &frame);
-		if (msg) schedule->schedule_work(schedule->handle, lv2_atom_total_size(msg), msg);
-	}
+	// Retrieve seed
+	const void* seedData = retrieve (handle, urids.bOops_seed, &size, &type, &valflags);
+	if (seedData && (type == urids.atom_Long)) {state->seed = *(int64_t*)seedData; state->seedRestored = true;}
+	else if (seedData && (type == urids.atom_Int)) {state->seed = *(int32_t*)seedData; state->seedRestored = true;}
 
-	else
-	{
-		// Free old sample
-		if (sample)
-		{
-			delete sample;
-			sample = nullptr;
-			sampleAmp = 1.0;
-		}
+	// Retrieve force mono
+	const void* monoData = retrieve (handle, urids.bOops_forceMono, &size, &type, &valflags);
+	if (monoData && (type == urids.atom_Bool)) state->forceMono = *(int32_t*)monoData;
 
-		// Load new sample
-		message.deleteMessage (CANT_OPEN_SAMPLE);
-		try {sample = new Sample (samplePath);}
+	// Load new sample (we are not in the audio thread)
+	if (samplePath[0] != 0)
+	{
+		try {state->sample = new Sample (samplePath);}
 		catch (std::bad_alloc &ba)
 		{
-			fprintf (stderr, "BOops.lv2: Can't allocate enoug memory to open sample file.\n");
-			message.setMessage (CANT_OPEN_SAMPLE);
+			fprintf (stderr, "BOops.lv2: Can't allocate enough memory to open sample file.\n");
+			state->sampleError = true;
 		}
 		catch (std::invalid_argument &ia)
 		{
 			fprintf (stderr, "%s\n", ia.what());
-			message.setMessage (CANT_OPEN_SAMPLE);
-		}
-
-		// Set new sample properties
-		if  (sample)
-		{
-			sample->start = sampleStart;
-			sample->end = sampleEnd;
-			sample->loop = bool (sampleLoop);
-			this->sampleAmp = sampleAmp;
+			state->sampleError = true;
 		}
+	}
 
-		scheduleNotifySamplePathToGui = true;
+	// Set new sample properties
+	if (state->sample)
+	{
+		state->sample->start = LIMIT (sampleStart, 0, state->sample->info.frames - 1);
+		state->sample->end = LIMIT (sampleEnd, state->sample->start, state->sample->info.frames);
+		state->sample->loop = bool (sampleLoop);
+		state->sampleAmp = LIMIT (sampleAmp, 0.0f, 1.0f);
 	}
 
 	// Retrieve transportGateKeys
@@ -1895,61 +2144,40 @@ LV2_State_Status BOops::state_restore (LV2_State_Retrieve_Function retrieve, LV2
 		const AtomKeys* atom = (const AtomKeys*) transportGateKeysData;
 		const int nr = LIMIT ((size - sizeof (LV2_Atom_Vector_Body)) / sizeof(int), 0, NR_PIANO_KEYS);
 
-		std::fill (transportGateKeys, transportGateKeys + NR_PIANO_KEYS, false);
+		std::fill (state->transportGateKeys, state->transportGateKeys + NR_PIANO_KEYS, false);
 		for (int i = 0; i < nr; ++i)
 		{
 			const int keyNr = atom->keys[i];
-			if ((keyNr >= 0) && (keyNr < NR_PIANO_KEYS)) transportGateKeys[keyNr] = true;
+			if ((keyNr >= 0) && (keyNr < NR_PIANO_KEYS)) state->transportGateKeys[keyNr] = true;
 		}
-		scheduleNotifyTransportGateKeys = true;
+		state->transportGateKeysRestored = true;
         }
 
 	// Retrieve pageNr
-	pageNr = 0;
 	const void* pageNrData = retrieve(handle, urids.bOops_pageID, &size, &type, &valflags);
 	if (pageNrData && (type == urids.atom_Int))
 	{
-		const int pgNr = LIMIT (*(const int*)pageNrData, 0, NR_PAGES - 1);
-
-		if (pgNr != pageNr)
-		{
-			Position np = backPosition();
-			pushBackPosition (np);
-		}
-
-		pageNr = pgNr;
-		if (pageMax < pageNr) pageMax = pageNr;
+		state->pageNr = LIMIT (*(const int*)pageNrData, 0, NR_PAGES - 1);
+		if (state->pageMax < state->pageNr) state->pageMax = state->pageNr;
         }
 
 	// Retrieve pageMax
-	pageMax = 0;
+	state->pageMax = 0;
 	const void* pageMaxData = retrieve(handle, urids.bOops_pageMax, &size, &type, &valflags);
 	if (pageMaxData && (type == urids.atom_Int))
 	{
-		pageMax = LIMIT (*(const int*)pageMaxData, 0, NR_PAGES - 1);
-
-		if (pageNr > pageMax)
-		{
-			// Limit pageNr to pageMax
-			pageNr = pageMax;
+		state->pageMax = LIMIT (*(const int*)pageMaxData, 0, NR_PAGES - 1);
 
-			// Schedule fader for page change
-			Position np = backPosition();
-			pushBackPosition (np);
-		}
+		// Limit pageNr to pageMax
+		if (state->pageNr > state->pageMax) state->pageNr = state->pageMax;
         }
 
 	// Retrieve editor data
-	editorPage = 0;
-	editorSlot = 0;
-
 	const void* editorPageData = retrieve(handle, urids.bOops_editorPage, &size, &type, &valflags);
-	if (editorPageData && (type == urids.atom_Int)) editorPage = LIMIT (*(const int*)editorPageData, 0, NR_PAGES - 1);
+	if (editorPageData && (type == urids.atom_Int)) state->editorPage = LIMIT (*(const int*)editorPageData, 0, NR_PAGES - 1);
 
 	const void* editorSlotData = retrieve(handle, urids.bOops_editorSlot, &size, &type, &valflags);
-	if (editorSlotData && (type == urids.atom_Int)) editorSlot = LIMIT (*(const int*)editorSlotData, 0, NR_SLOTS - 1);
-
-	scheduleNotifyStatus = true;
+	if (editorSlotData && (type == urids.atom_Int)) state->editorSlot = LIMIT (*(const int*)editorSlotData, 0, NR_SLOTS - 1);
 
 	// Retrieve page control properties
 	const void* pageControlsData = retrieve(handle, urids.bOops_pageControls, &size, &type, &valflags);
@@ -1958,9 +2186,8 @@ LV2_State_Status BOops::state_restore (LV2_State_Retrieve_Function retrieve, LV2
 		const AtomPageControls* atom = (const AtomPageControls*) pageControlsData;
 		const int nr = LIMIT ((size - sizeof (LV2_Atom_Vector_Body)) / sizeof(PageControls), 0, NR_PAGES - 1);
 
-		for (Page& page : pages) page.controls = {0, 0, 0, 0};
-		for (int i = 0; i < nr; ++i) pages[i].controls = atom->data[i];
-		for (int i = 0; i < NR_PAGES; ++i) scheduleNotifyPageControls[i] = true;
+		for (int i = 0; i < NR_PAGES; ++i) state->pages[i].controls = {0, 0, 0, 0};
+		for (int i = 0; i < nr; ++i) state->pages[i].controls = atom->data[i];
         }
 
 	// Retrieve pattern
@@ -1970,13 +2197,7 @@ LV2_State_Status BOops::state_restore (LV2_State_Retrieve_Function retrieve, LV2
 		// Clear pads
 		for (int pg = 0; pg < NR_PAGES; ++pg)
 		{
-			for (std::array<Pad, NR_STEPS>& row : pages[pg].pads) row.fill (Pad());
-		}
-
-		// Also clear pads stored in slots
-		for (Slot& s : slots)
-		{
-			for (unsigned int i = 0; i < NR_STEPS; ++i) s.setPad (i, Pad());
+			for (std::array<Pad, NR_STEPS>& row : state->pages[pg].pads) row.fill (Pad());
 		}
 
 		std::string padDataString = (char*) padData;
@@ -2074,7 +2295,7 @@ LV2_State_Status BOops::state_restore (LV2_State_Retrieve_Function retrieve, LV2
 
 				if (nextPos > 0) padDataString.erase (0, nextPos);
 
-				Pad& p = pages[pgNr].pads[slotNr][stepNr];
+				Pad& p = state->pages[pgNr].pads[slotNr][stepNr];
 				switch (i)
 				{
 					case 3:	p.gate = LIMIT (val, 0, 1);
@@ -2088,16 +2309,12 @@ LV2_State_Status BOops::state_restore (LV2_State_Retrieve_Function retrieve, LV2
 
 					default:break;
 				}
-				if (pageNr == pgNr) slots[slotNr].setPad (stepNr, p);
 			}
 		}
-
-		// Schedule notify GUI
-		scheduleNotifyAllSlots = true;
 	}
 
 	// Retrieve keys
-	for (Page& p : pages) for (std::array<bool, NR_PIANO_KEYS + 1>& k : p.keys) k.fill (false);
+	for (int pg = 0; pg < NR_PAGES; ++pg) for (std::array<bool, NR_PIANO_KEYS + 1>& k : state->pages[pg].keys) k.fill (false);
 	const void* keysData = retrieve(handle, urids.bOops_keysData, &size, &type, &valflags);
 	if (keysData && (type == urids.atom_String))
 	{
@@ -2162,17 +2379,14 @@ LV2_State_Status BOops::state_restore (LV2_State_Retrieve_Function retrieve, LV2
 					break;
 				}
 
-				hstr2bool<std::array<bool, NR_PIANO_KEYS + 1>> (s.substr (kPos + 7, ePos - kPos - 7).c_str(), pages[pageNr].keys[sl]);
+				hstr2bool<std::array<bool, NR_PIANO_KEYS + 1>> (s.substr (kPos + 7, ePos - kPos - 7).c_str(), state->pages[pageNr].keys[sl]);
 				s.erase (0, ePos + 1);
 			}
 		}
-
-		scheduleNotifyAllSlots = true;
 	}
-	for (int i = 0; i < NR_SLOTS; ++i) slots[i].setSlotKeys (pages[pageNr].keys[i]);
 
 	// Retrieve shapes
-	for (Page& p : pages) for (Shape<SHAPE_MAXNODES>& s : p.shapes) s = Shape<SHAPE_MAXNODES>();
+	for (int pg = 0; pg < NR_PAGES; ++pg) for (Shape<SHAPE_MAXNODES>& s : state->pages[pg].shapes) s = Shape<SHAPE_MAXNODES>();
 	const void* shapesData = retrieve(handle, urids.bOops_shapeData, &size, &type, &valflags);
 	if (shapesData && (type == urids.atom_String))
 	{
@@ -2228,10 +2442,9 @@ LV2_State_Status BOops::state_restore (LV2_State_Retrieve_Function retrieve, LV2
 						{
 							if (!pageShapes[pg][sl].validateShape ()) pageShapes[pg][sl].setDefaultShape ();
 						}
-						pages[pg].shapes[sl] = pageShapes[pg][sl];
+						state->pages[pg].shapes[sl] = pageShapes[pg][sl];
 					}
 				}
-				scheduleNotifyAllSlots = true;
 			}
 
 			// Param shapes
@@ -2245,19 +2458,98 @@ LV2_State_Status BOops::state_restore (LV2_State_Retrieve_Function retrieve, LV2
 					{
 						if (!paramShapes[sl].validateShape ()) paramShapes[sl].setDefaultShape ();
 					}
-					slots[sl].shape = paramShapes[sl];
-					scheduleNotifyShape[sl] = true;
+					state->paramShapes[sl] = paramShapes[sl];
 				}
+				state->paramShapesRestored = true;
 			}
 
 			startPos = nextPos;
 		}
 	}
-	for (int i = 0; i < NR_SLOTS; ++i) slots[i].setSlotShape (pages[pageNr].shapes[i]);
+
+	// Hand over to the audio thread via the worker if running. Otherwise
+	// install directly.
+	if (activated && schedule)
+	{
+		AtomState sAtom = {{sizeof (StateBundle*), urids.bOops_installState}, state};
+		if (schedule->schedule_work (schedule->handle, sizeof (sAtom), &sAtom) == LV2_WORKER_SUCCESS) return LV2_STATE_SUCCESS;
+		fprintf (stderr, "BOops.lv2: Can't schedule state installation.\n");
+		freeState (state);
+		return LV2_STATE_ERR_UNKNOWN;
+	}
+
+	installState (state);
+	freeState (state);
 
 	return LV2_STATE_SUCCESS;
 }
 
+void BOops::installState (StateBundle* state)
+{
+	// Swap pages and sample. The bundle takes over the old ones to free them.
+	state->pages = pages.exchange (state->pages);
+	std::swap (sample, state->sample);
+	sampleAmp = state->sampleAmp;
+	forceMono = state->forceMono;
+	if (state->seedRestored)
+	{
+		setSeed (state->seed);
+		for (Slot& s : slots)
+		{
+			if (s.fx) s.fx->seed (nextSeed ());
+		}
+	}
+	if (state->sampleError) message.setMessage (CANT_OPEN_SAMPLE);
+	else message.deleteMessage (CANT_OPEN_SAMPLE);
+
+	if (state->transportGateKeysRestored)
+	{
+		std::copy (state->transportGateKeys, state->transportGateKeys + NR_PIANO_KEYS, transportGateKeys);
+		scheduleNotifyTransportGateKeys = true;
+	}
+
+	// Schedule fader for page change
+	if (state->pageNr != pageNr)
+	{
+		Position np = backPosition();
+		pushBackPosition (np);
+	}
+
+	pageNr = state->pageNr;
+	pageMax = state->pageMax;
+	editorPage = state->editorPage;
+	editorSlot = state->editorSlot;
+
+	// Copy page data to slots
+	for (int i = 0; i < NR_SLOTS; ++i)
+	{
+		for (int j = 0; j < NR_STEPS; ++j) slots[i].setPad (j, pages[pageNr].pads[i][j]);
+		slots[i].setSlotKeys (pages[pageNr].keys[i]);
+		slots[i].setSlotShape (pages[pageNr].shapes[i]);
+		if (state->paramShapesRestored)
+		{
+			slots[i].shape = state->paramShapes[i];
+			scheduleNotifyShape[i] = true;
+		}
+	}
+
+	setAllStateFragmentsDirty ();
+
+	// Schedule notify GUI
+	scheduleNotifyAllSlotsToGui ();
+	std::fill (scheduleNotifyPageControls, scheduleNotifyPageControls + NR_PAGES, true);
+	scheduleNotifySamplePathToGui = true;
+	scheduleNotifyStatus = true;
+}
+
+void BOops::freeState (StateBundle* state)
+{
+	if (!state) return;
+	if (state->pages) delete[] state->pages;
+	if (state->sample) delete state->sample;
+	delete state;
+}
+
 LV2_Worker_Status BOops::work (LV2_Worker_Respond_Function respond, LV2_Worker_Respond_Handle handle, uint32_t size, const void* data)
 {
 	const LV2_Atom* atom = (const LV2_Atom*)data;
@@ -2287,6 +2579,20 @@ LV2_Worker_Status BOops::work (LV2_Worker_Respond_Function respond, LV2_Worker_R
 		if (sAtom->sample) delete sAtom->sample;
     }
 
+	// Free old state. Wait for state_save () calls which may still read it.
+	else if (atom->type == urids.bOops_freeState)
+	{
+		const AtomState* sAtom = (const AtomState*) atom;
+		while (stateSaving > 0) std::this_thread::sleep_for (std::chrono::milliseconds (1));
+		freeState (sAtom->state);
+	}
+
+	// Forward restored state to be installed
+	else if (atom->type == urids.bOops_installState)
+	{
+		respond (handle, size, data);
+	}
+
 	// Load sample
 	else if ((atom->type == urids.atom_Object) && (((LV2_Atom_Object*)atom)->body.otype == urids.bOops_samplePathEvent))
 	{
@@ -2426,6 +2732,7 @@ LV2_Worker_Status BOops::work_response (uint32_t size, const void* data)
 		// Install new Fx
 		slots[nAtom->index].fx = nAtom->fx;
 		slots[nAtom->index].effect = BOopsEffectsIndex (nAtom->effect);
+		if (nAtom->fx) nAtom->fx->setQuality (interpolation);
 		scheduleSetFx[nAtom->index] = false;
 	}
 
@@ -2450,6 +2757,17 @@ LV2_Worker_Status BOops::work_response (uint32_t size, const void* data)
 		scheduleStateChanged = true;
 	}
 
+	// Install restored state
+	else if (atom->type == urids.bOops_installState)
+	{
+		const AtomState* nAtom = (const AtomState*) data;
+		installState (nAtom->state);
+
+		// Schedule worker to free old state
+		AtomState sAtom = {{sizeof (StateBundle*), urids.bOops_freeState}, nAtom->state};
+		workerSchedule->schedule_work (workerSchedule->handle, sizeof (sAtom), &sAtom);
+	}
+
 	return LV2_WORKER_SUCCESS;
 }
 
@@ -22,6 +22,8 @@
 #define BOOPS_HPP_
 
 #include <cmath>
+#include <string>
+#include <atomic>
 #include <lv2/lv2plug.in/ns/lv2core/lv2.h>
 #include <lv2/lv2plug.in/ns/ext/atom/atom.h>
 #include <lv2/lv2plug.in/ns/ext/atom/util.h>
@@ -38,6 +40,7 @@
 #include "Message.hpp"
 #include "StaticArrayList.hpp"
 #include "MidiKey.hpp"
+#include "WaveformBin.hpp"
 
 class Sample; 	// Forward declaration
 
@@ -91,19 +94,27 @@ public:
 	LV2_State_Status state_restore(LV2_State_Retrieve_Function retrieve, LV2_State_Handle handle, uint32_t flags, const LV2_Feature* const* features);
 	LV2_Worker_Status work (LV2_Worker_Respond_Function respond, LV2_Worker_Respond_Handle handle, uint32_t size, const void* data);
 	LV2_Worker_Status work_response (uint32_t size, const void* data);
+	void setSeed (const uint32_t value);
+	uint32_t nextSeed ();
+	void setInterpolation (const int value);
+	int getInterpolation () const {return interpolation;}
 
 	LV2_URID_Map* map;
 	LV2_Worker_Schedule* workerSchedule;
 
 private:
 	Stereo getSample (const Position& p, const double pos);
+	Stereo getInput (const uint32_t frame) const;
 	void play(uint32_t start, uint32_t end);
 	void resizeSteps ();
+	void scheduleNotifyAllSlotsToGui ();
 	void notifyAllSlotsToGui ();
 	void notifyShapeToGui (const int slot);
 	void notifyMessageToGui ();
 	void notifyStatusToGui ();
+	void updateWaveform (const double pos, const float value);
 	void notifyWaveformToGui (const int start, const int end);
+	void notifyWaveformRangeToGui (const int start, const int end);
 	void notifyTransportGateKeysToGui ();
 	void notifySamplePathToGui ();
 	void notifyStateChanged ();
@@ -115,6 +126,15 @@ private:
 	LV2_Atom_Forge_Ref forgeTransportGateKeys (LV2_Atom_Forge* forge, LV2_Atom_Forge_Frame* frame, const int* keys, const size_t size);
 	LV2_Atom_Forge_Ref forgePads (LV2_Atom_Forge* forge, LV2_Atom_Forge_Frame* frame, const int page, const int slot, const size_t size);
 	LV2_Atom_Forge_Ref forgePageControls (LV2_Atom_Forge* forge, LV2_Atom_Forge_Frame* frame, const int pageId);
+	void setAllStateFragmentsDirty ();
+	struct StateBundle;
+	void installState (StateBundle* state);
+	void freeState (StateBundle* state);
+	static Page* newPages ();
+	const std::string& getPadsStateFragment (const int page, const int slot);
+	const std::string& getKeysStateFragment (const int page, const int slot);
+	const std::string& getShapeStateFragment (const int page, const int slot);
+	const std::string& getParamShapeStateFragment (const int slot);
 	double getPositionFromBeats (const Transport& transport, const double beats);
 	double getPositionFromFrames (const Transport& transport, const uint64_t frames);
 	uint64_t getFramesFromPosition (const Transport& transport, const double position) const;
@@ -136,7 +156,8 @@ private:
 	Position positions[2];
 	bool transportGateKeys[NR_PIANO_KEYS];
 
-	std::array<Page, NR_PAGES> pages;
+	std::atomic<Page*> pages;	// Swapped by installState ()
+	std::atomic<int> stateSaving;	// Nr of state_save () calls in progress
 	int pageNr;
 	int pageMax;
 	bool midiLearn;
@@ -167,13 +188,15 @@ public:	std::array<Slot, NR_SLOTS> slots;
 private:
 	Sample* sample;
 	float sampleAmp;
-	float waveform[WAVEFORMSIZE];
+	WaveformAccumulator waveform[WAVEFORMSIZE];
+	int32_t waveformSent[WAVEFORMSIZE];
 	int waveformCounter;
 	int lastWaveformCounter;
 
 	Message message;
 	bool ui_on;
 	bool scheduleNotifyAllSlots;
+	bool scheduleNotifySlot[NR_PAGES][NR_SLOTS];
 	bool scheduleNotifyPageControls[NR_PAGES];
 	bool scheduleNotifyShape[NR_SLOTS];
 	bool scheduleNotifyStatus;
@@ -186,6 +209,38 @@ private:
 	bool scheduleStateChanged;
 	bool scheduleInit;
 
+	// Downmix the audio input to mono. Set by changes of the FORCE_MONO
+	// port and by state (also BOops-render -M). Stored in the state, and
+	// sent to the GUI to update the port.
+	bool forceMono;
+	float forceMonoPort;	// Last FORCE_MONO port value
+
+	// Resampler quality (RESAMPLER_HERMITE or RESAMPLER_SINC) for the
+	// buffer-reading effects. Set by the INTERPOLATION port. Also read by
+	// the worker for new effects.
+	std::atomic<int> interpolation;
+
+	// Random seeds for the effects are derived from the instance seed and a
+	// counter. Time based unless set (state or setSeed ()). Always stored
+	// in the state.
+	uint32_t seed;
+	uint64_t seedCounter;
+
+	// Serialized state, cached per page and slot. Only dirty fragments are
+	// regenerated in state_save (). Set dirty from run (), cleared by the
+	// state_save () thread before regeneration.
+	struct StateFragment
+	{
+		StateFragment () : dirty (true), data () {}
+		std::atomic<bool> dirty;
+		std::string data;
+	};
+
+	std::array<std::array<StateFragment, NR_SLOTS>, NR_PAGES> padsStateFragments;
+	std::array<std::array<StateFragment, NR_SLOTS>, NR_PAGES> keysStateFragments;
+	std::array<std::array<StateFragment, NR_SLOTS>, NR_PAGES> shapeStateFragments;
+	std::array<StateFragment, NR_SLOTS> paramShapeStateFragments;
+
 	struct Atom_BufferList
 	{
 		LV2_Atom atom;
@@ -212,6 +267,33 @@ private:
 		Fx* fx;
 	};
 
+	// Complete configuration restored from state. Built off the audio
+	// thread and installed in one go by installState ().
+	struct StateBundle
+	{
+		Page* pages;
+		std::array<Shape<SHAPE_MAXNODES>, NR_SLOTS> paramShapes;
+		bool paramShapesRestored;
+		bool transportGateKeys[NR_PIANO_KEYS];
+		bool transportGateKeysRestored;
+		int pageNr;
+		int pageMax;
+		int editorPage;
+		int editorSlot;
+		Sample* sample;
+		float sampleAmp;
+		bool sampleError;
+		uint32_t seed;
+		bool seedRestored;
+		bool forceMono;
+	};
+
+	struct AtomState
+	{
+		LV2_Atom atom;
+		StateBundle* state;
+	};
+
 	struct AtomSample
 	{
 		LV2_Atom atom;
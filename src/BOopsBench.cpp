@@ -0,0 +1,410 @@
+/* B.Oops
+ * Glitch effect sequencer LV2 plugin
+ *
+ * Copyright (C) 2020 by Sven Jähnichen
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Effect micro-benchmark. Creates each effect via Slot::newFx() with its
+ * default parameters (FxDefaults.hpp) and a fully set pad pattern, feeds
+ * it with noise via Slot::play() and reports ns, instructions and cache
+ * misses per sample for the given sample rates. Then does the same for
+ * full pages of NR_SLOTS chained slots, like BOops::play() does. All
+ * random generators are seeded from BENCH_SEED. Instructions and cache
+ * misses are read from the Linux perf counters (if available).
+ * The tail column shows ns per sample for a short noise burst followed by
+ * silence. It should not exceed the noise value much if denormals are
+ * flushed (DenormalGuard, like BOops::run() does).
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <lv2/lv2plug.in/ns/lv2core/lv2.h>
+#include <lv2/lv2plug.in/ns/ext/urid/urid.h>
+#include <lv2/lv2plug.in/ns/ext/worker/worker.h>
+#include "BOops.hpp"
+#include "Slot.hpp"
+#include "FxDefaults.hpp"
+#include "DenormalGuard.hpp"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define BENCH_DEFAULT_DURATION 2.0
+#define BENCH_BPM 120.0
+#define BENCH_STEPS 16
+#define BENCH_PADSIZE 4
+#define BENCH_SEED 1
+#define BENCH_BURST 0.1
+
+/*
+ * Local host: URID map only. Scheduled work is dropped as the benchmark
+ * doesn't use the plugin run() cycle.
+ */
+struct BenchHost
+{
+	std::map<std::string, LV2_URID> urids;
+
+	static LV2_URID map (LV2_URID_Map_Handle handle, const char* uri)
+	{
+		BenchHost* host = (BenchHost*) handle;
+		std::map<std::string, LV2_URID>::const_iterator it = host->urids.find (uri);
+		if (it != host->urids.end()) return it->second;
+		const LV2_URID urid = host->urids.size() + 1;
+		host->urids[uri] = urid;
+		return urid;
+	}
+
+	static LV2_Worker_Status scheduleWork (LV2_Worker_Schedule_Handle handle, uint32_t size, const void* data)
+	{
+		return LV2_WORKER_SUCCESS;
+	}
+};
+
+/*
+ * Hardware event counter. Invalid (and reporting n/a) if perf events
+ * aren't supported or permitted.
+ */
+class PerfCounter
+{
+public:
+	PerfCounter (const uint64_t config) : fd (-1)
+	{
+#ifdef __linux__
+		perf_event_attr attr;
+		memset (&attr, 0, sizeof (attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof (attr);
+		attr.config = config;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+	}
+
+	~PerfCounter ()
+	{
+#ifdef __linux__
+		if (fd >= 0) close (fd);
+#endif
+	}
+
+	PerfCounter (const PerfCounter& that) = delete;
+	PerfCounter& operator= (const PerfCounter& that) = delete;
+
+	bool isValid () const {return (fd >= 0);}
+
+	void start ()
+	{
+#ifdef __linux__
+		if (fd < 0) return;
+		ioctl (fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl (fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+	}
+
+	uint64_t stop ()
+	{
+		uint64_t count = 0;
+#ifdef __linux__
+		if (fd < 0) return 0;
+		ioctl (fd, PERF_EVENT_IOC_DISABLE, 0);
+		if (read (fd, &count, sizeof (count)) != sizeof (count)) count = 0;
+#endif
+		return count;
+	}
+
+protected:
+	int fd;
+};
+
+#ifdef __linux__
+#define BENCH_INSTRUCTIONS PERF_COUNT_HW_INSTRUCTIONS
+#define BENCH_CACHE_MISSES PERF_COUNT_HW_CACHE_MISSES
+#else
+#define BENCH_INSTRUCTIONS 0
+#define BENCH_CACHE_MISSES 0
+#endif
+
+struct BenchResult
+{
+	double nsPerSample;
+	double instructionsPerSample;
+	double cacheMissesPerSample;
+};
+
+static volatile float sink = 0.0f;
+
+static Slot* newSlot (BOops* plugin, const BOopsEffectsIndex effect, const double framesPerStep)
+{
+	float params[NR_PARAMS];
+	std::copy (fxDefaultValues[effect].begin(), fxDefaultValues[effect].end(), params);
+
+	Slot* slot = new Slot (plugin, effect, params, nullptr, BENCH_STEPS, 1.0f, framesPerStep);
+	for (int i = 0; i < BENCH_STEPS; i += BENCH_PADSIZE) slot->setPad (i, Pad (1.0f, BENCH_PADSIZE, 1.0f));
+	return slot;
+}
+
+/*
+ * Plays the input through the chain of slots, the same way BOops::play()
+ * does in the pattern mode: Slot by slot over sub-blocks of
+ * BOOPS_BLOCKSIZE frames (single frames if FxSurprise is used).
+ */
+static BenchResult run
+(
+	const std::vector<Slot*>& chain, const std::vector<Stereo>& input, const double framesPerStep,
+	PerfCounter& instructions, PerfCounter& cacheMisses, const bool flush
+)
+{
+	const DenormalGuard denormalGuard (flush);
+	std::vector<int> lastSteps (chain.size(), -1);
+	float acc = 0.0f;
+
+	size_t blockSize = BOOPS_BLOCKSIZE;
+	for (const Slot* s : chain)
+	{
+		if (s->effect == FX_SURPRISE) blockSize = 1;
+	}
+
+	const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	instructions.start();
+	cacheMisses.start();
+
+	for (size_t b0 = 0; b0 < input.size(); b0 += blockSize)
+	{
+		const size_t n = std::min (blockSize, input.size() - b0);
+		double steps[BOOPS_BLOCKSIZE];
+		Stereo outputs[BOOPS_BLOCKSIZE];
+		for (size_t k = 0; k < n; ++k)
+		{
+			steps[k] = fmod (double (b0 + k) / framesPerStep, BENCH_STEPS);
+			outputs[k] = input[b0 + k];
+		}
+
+		for (size_t j = 0; j < chain.size(); ++j)
+		{
+			Slot& s = *chain[j];
+
+			for (size_t k = 0; k < n; )
+			{
+				// Init step
+				const int iStep = steps[k];
+				if (lastSteps[j] != iStep)
+				{
+					const int iStart = s.startPos[iStep];
+					if ((lastSteps[j] < 0) || (s.startPos[lastSteps[j]] != iStart))
+					{
+						s.end ();
+						if (iStart >= 0) s.init (iStart);
+					}
+					lastSteps[j] = iStep;
+				}
+
+				// Frames up to the next step
+				size_t m = k + 1;
+				while ((m < n) && (int (steps[m]) == iStep)) ++m;
+				s.play (&steps[k], &outputs[k], m - k);
+				s.mixf = 1.0f;
+				k = m;
+			}
+		}
+
+		for (size_t k = 0; k < n; ++k) acc += outputs[k].left + outputs[k].right;
+	}
+
+	const uint64_t nrCacheMisses = cacheMisses.stop();
+	const uint64_t nrInstructions = instructions.stop();
+	const double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - t0).count();
+	sink = sink + acc;
+
+	const double n = input.size();
+	return BenchResult
+	{
+		1.0e9 * seconds / n,
+		(instructions.isValid() ? double (nrInstructions) / n : -1.0),
+		(cacheMisses.isValid() ? double (nrCacheMisses) / n : -1.0)
+	};
+}
+
+static void print (const std::string& name, const BenchResult& result, const BenchResult& tail)
+{
+	char instr[32] = "n/a";
+	char misses[32] = "n/a";
+	if (result.instructionsPerSample >= 0.0) snprintf (instr, 32, "%.1f", result.instructionsPerSample);
+	if (result.cacheMissesPerSample >= 0.0) snprintf (misses, 32, "%.4f", result.cacheMissesPerSample);
+	printf ("  %-18s %12.2f %12.2f %14s %14s\n", name.c_str(), result.nsPerSample, tail.nsPerSample, instr, misses);
+}
+
+static void usage ()
+{
+	fprintf
+	(
+		stderr,
+		"Usage: BOops-bench [OPTION]...\n"
+		"Measures the processing costs of the B.Oops effects.\n\n"
+		"  -d, --duration SEC     duration per measurement (default: %.1f)\n"
+		"  -r, --rate RATE        sample rate, may be repeated (default: 44100, 48000, 96000)\n"
+		"  -b, --bundle DIR       bundle directory containing inc/ (default: .)\n"
+		"  -f, --flush 0|1        flush denormals to zero (default: 1)\n"
+		"  -q, --quality 0|1      interpolation, 0 = Hermite, 1 = sinc (default: %i)\n"
+		"  -h, --help             this help\n",
+		BENCH_DEFAULT_DURATION,
+		RESAMPLER_DEFAULT_QUALITY
+	);
+}
+
+int main (int argc, char** argv)
+{
+	double duration = BENCH_DEFAULT_DURATION;
+	std::vector<double> rates;
+	std::string bundle = ".";
+	bool flush = true;
+	int quality = RESAMPLER_DEFAULT_QUALITY;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if ((arg == "-h") || (arg == "--help"))
+		{
+			usage ();
+			return 0;
+		}
+
+		if (i + 1 >= argc)
+		{
+			usage ();
+			return 1;
+		}
+
+		const std::string val = argv[++i];
+		if ((arg == "-d") || (arg == "--duration")) duration = atof (val.c_str());
+		else if ((arg == "-r") || (arg == "--rate")) rates.push_back (atof (val.c_str()));
+		else if ((arg == "-b") || (arg == "--bundle")) bundle = val;
+		else if ((arg == "-f") || (arg == "--flush")) flush = (atoi (val.c_str()) != 0);
+		else if ((arg == "-q") || (arg == "--quality")) quality = LIMIT (atoi (val.c_str()), RESAMPLER_HERMITE, RESAMPLER_SINC);
+		else
+		{
+			usage ();
+			return 1;
+		}
+	}
+
+	if (rates.empty()) rates = {44100.0, 48000.0, 96000.0};
+	for (double r : rates)
+	{
+		if ((r <= 0.0) || (duration <= 0.0))
+		{
+			usage ();
+			return 1;
+		}
+	}
+
+	BenchHost host;
+	LV2_URID_Map map = {&host, BenchHost::map};
+	LV2_Worker_Schedule schedule = {&host, BenchHost::scheduleWork};
+	const LV2_Feature mapFeature = {LV2_URID__map, &map};
+	const LV2_Feature scheduleFeature = {LV2_WORKER__schedule, &schedule};
+	const LV2_Feature* features[] = {&mapFeature, &scheduleFeature, nullptr};
+	const std::string bundlePath = bundle + "/";
+
+	PerfCounter instructions (BENCH_INSTRUCTIONS);
+	PerfCounter cacheMisses (BENCH_CACHE_MISSES);
+	if ((!instructions.isValid()) || (!cacheMisses.isValid()))
+	{
+		fprintf (stderr, "BOops-bench: Perf counters not available. Check /proc/sys/kernel/perf_event_paranoid.\n");
+	}
+
+	for (double rate : rates)
+	{
+		BOops* plugin = nullptr;
+		try {plugin = new BOops (rate, bundlePath.c_str(), features);}
+		catch (std::exception& exc)
+		{
+			fprintf (stderr, "BOops-bench: %s\n", exc.what());
+			return 1;
+		}
+		plugin->setInterpolation (quality);
+
+		// One sixteenth note per step
+		const double framesPerStep = rate * 60.0 / BENCH_BPM / 4.0;
+
+		// Reproducible noise input
+		std::minstd_rand rnd (1);
+		std::uniform_real_distribution<float> dist (-0.5f, 0.5f);
+		std::vector<Stereo> input (duration * rate);
+		for (Stereo& s : input) s = Stereo (dist (rnd), dist (rnd));
+
+		// Noise burst followed by silence
+		std::vector<Stereo> tail (input.size(), Stereo());
+		std::copy (input.begin(), input.begin() + std::min (size_t (BENCH_BURST * rate), input.size()), tail.begin());
+
+		printf ("\n%.0f Hz, %.1f s per measurement\n", rate, duration);
+		printf ("  %-18s %12s %12s %14s %14s\n", "Effect", "ns/sample", "tail ns/s.", "instr/sample", "misses/sample");
+
+		// Single effects
+		for (int fx = FX_NONE + 1; fx < NR_FX; ++fx)
+		{
+			plugin->setSeed (BENCH_SEED);
+			std::vector<Slot*> chain = {newSlot (plugin, BOopsEffectsIndex (fx), framesPerStep)};
+			const BenchResult result = run (chain, input, framesPerStep, instructions, cacheMisses, flush);
+			for (Slot* s : chain) delete s;
+
+			plugin->setSeed (BENCH_SEED);
+			chain = {newSlot (plugin, BOopsEffectsIndex (fx), framesPerStep)};
+			print (fxIconFileNames[fx], result, run (chain, tail, framesPerStep, instructions, cacheMisses, flush));
+			for (Slot* s : chain) delete s;
+		}
+
+		// Full pages
+		const int nrEffects = NR_FX - 1;
+		for (int page = 0; page * NR_SLOTS < nrEffects; ++page)
+		{
+			BenchResult results[2];
+			for (int j = 0; j < 2; ++j)
+			{
+				plugin->setSeed (BENCH_SEED);
+				std::vector<Slot*> chain;
+				for (int i = 0; i < NR_SLOTS; ++i)
+				{
+					const int fx = FX_NONE + 1 + (page * NR_SLOTS + i) % nrEffects;
+					chain.push_back (newSlot (plugin, BOopsEffectsIndex (fx), framesPerStep));
+				}
+				results[j] = run (chain, (j == 0 ? input : tail), framesPerStep, instructions, cacheMisses, flush);
+				for (Slot* s : chain) delete s;
+			}
+			print ("Page " + std::to_string (page + 1) + " (" + std::to_string (NR_SLOTS) + " slots)", results[0], results[1]);
+		}
+
+		delete plugin;
+	}
+
+	return 0;
+}
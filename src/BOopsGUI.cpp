@@ -79,6 +79,7 @@ BOopsGUI::BOopsGUI (const char *bundle_path, const LV2_Feature *const *features,
 	pageMax (0),
 	pageOffset (0),
 	patterns {},
+	padTiles (), padDirty (), padDamage (), padsDirty (false), padsFullRedraw (true),
 	clipBoard (),
 	cursor (0), wheelScrolled (false), padPressed (false), deleteMode (false),
 	actSlot (-1), dragOrigin {-1, -1},
@@ -87,6 +88,10 @@ BOopsGUI::BOopsGUI (const char *bundle_path, const LV2_Feature *const *features,
 	messageLabel (400, 45, 600, 20, "ctlabel", ""),
 	helpButton (1168, 18, 24, 24, "widget", BOOPS_LABEL_HELP),
 	ytButton (1198, 18, 24, 24, "widget", BOOPS_LABEL_TUTORIAL),
+	interpolationLabel (1130, 52, 90, 8, "smlabel", BOOPS_LABEL_INTERPOLATION),
+	interpolationListBox (1130, 62, 90, 20, 90, 60, "menu", BItems::ItemList ({{0, BOOPS_LABEL_HERMITE}, {1, BOOPS_LABEL_SINC}}), 0),
+	monoLabel (1030, 52, 90, 8, "smlabel", BOOPS_LABEL_INPUT),
+	monoListBox (1030, 62, 90, 20, 90, 60, "menu", BItems::ItemList ({{0, BOOPS_LABEL_STEREO}, {1, BOOPS_LABEL_MONO}}), 0),
 
 	settingsContainer (10, 90, 1220, 40, "widget"),
 	playButton (8, 8, 24, 24, "widget", BOOPS_LABEL_PLAY),
@@ -239,6 +244,8 @@ BOopsGUI::BOopsGUI (const char *bundle_path, const LV2_Feature *const *features,
 		slotParams[i].shape.setDefaultShape();
 		slotParams[i].optionWidget = nullptr;
 	}
+	optionPanels.fill (nullptr);
+	optionPanelThemed.fill (false);
 
 	// Init shapeEditor
 	shapeEditor.page = 0;
@@ -282,6 +289,8 @@ BOopsGUI::BOopsGUI (const char *bundle_path, const LV2_Feature *const *features,
 	controllerWidgets[STEPS] = (BWidgets::ValueWidget*) &stepsListBox;
 	controllerWidgets[BASE] = (BWidgets::ValueWidget*) &sequenceBaseListBox;
 	controllerWidgets[BASE_VALUE] = (BWidgets::ValueWidget*) &sequenceSizeSelect;
+	controllerWidgets[INTERPOLATION] = (BWidgets::ValueWidget*) &interpolationListBox;
+	controllerWidgets[FORCE_MONO] = (BWidgets::ValueWidget*) &monoListBox;
 	for (int i = 0; i < NR_SLOTS; ++i)
 	{
 		controllerWidgets[SLOTS + i * (SLOTS_PARAMS + NR_PARAMS) + SLOTS_EFFECT] = (BWidgets::ValueWidget*) &slots[i].container;
@@ -552,6 +561,10 @@ BOopsGUI::BOopsGUI (const char *bundle_path, const LV2_Feature *const *features,
 	mContainer.add (settingsContainer);
 	mContainer.add (helpButton);
 	mContainer.add (ytButton);
+	mContainer.add (interpolationLabel);
+	mContainer.add (interpolationListBox);
+	mContainer.add (monoLabel);
+	mContainer.add (monoListBox);
 	mContainer.add (messageLabel);
 
 	mContainer.add (midiBox);
@@ -595,7 +608,12 @@ BOopsGUI::~BOopsGUI ()
 {
 	for (SlotParam& s : slotParams)
 	{
-		if (s.optionWidget) delete (s.optionWidget);
+		if (s.optionWidget) s.container.release (s.optionWidget);
+	}
+
+	for (OptionWidget* o : optionPanels)
+	{
+		if (o) delete (o);
 	}
 
 	if (sampleChooser) delete sampleChooser;
@@ -779,7 +797,7 @@ void BOopsGUI::port_event(uint32_t port, uint32_t buffer_size,
 			// Status notifications
 			else if (obj->body.otype == urids.bOops_statusEvent)
 			{
-				LV2_Atom *oPos = NULL, *oPg = NULL, *oMax = NULL, *oMid = NULL, *oEdPg = NULL, *oEdSl = NULL;
+				LV2_Atom *oPos = NULL, *oPg = NULL, *oMax = NULL, *oMid = NULL, *oEdPg = NULL, *oEdSl = NULL, *oMono = NULL;
 				lv2_atom_object_get
 				(
 					obj,
@@ -789,9 +807,13 @@ void BOopsGUI::port_event(uint32_t port, uint32_t buffer_size,
 					urids.bOops_midiLearned, &oMid,
 					urids.bOops_editorPage, &oEdPg,
 					urids.bOops_editorSlot, &oEdSl,
+					urids.bOops_forceMono, &oMono,
 					NULL
 				);
 
+				// Force mono restored from state: Also update the port
+				if (oMono && (oMono->type == urids.atom_Bool)) monoListBox.setValue (((LV2_Atom_Bool*)oMono)->body ? 1 : 0);
+
 				if (oPos && (oPos->type == urids.atom_Double))
 				{
 					const double oCursor = cursor;
@@ -911,10 +933,10 @@ void BOopsGUI::port_event(uint32_t port, uint32_t buffer_size,
 				if (oData && (oData->type == urids.atom_Vector))
 				{
 					const LV2_Atom_Vector* vec = (const LV2_Atom_Vector*) oData;
-					if (vec->body.child_type == urids.atom_Float)
+					if (vec->body.child_type == urids.atom_Int)
 					{
-						uint32_t size = (uint32_t) ((oData->size - sizeof(LV2_Atom_Vector_Body)) / sizeof (float));
-						float* data = (float*) (&vec->body + 1);
+						uint32_t size = (uint32_t) ((oData->size - sizeof(LV2_Atom_Vector_Body)) / sizeof (int32_t));
+						const int32_t* data = (const int32_t*) (&vec->body + 1);
 						if ((start >= 0) && (size > 0))
 						{
 							monitor.addData (start, size, data);
@@ -967,6 +989,14 @@ void BOopsGUI::resize ()
 	RESIZE (messageLabel, 400, 45, 600, 20, sz);
 	RESIZE (helpButton, 1168, 18, 24, 24, sz);
 	RESIZE (ytButton, 1198, 18, 24, 24, sz);
+	RESIZE (interpolationLabel, 1130, 52, 90, 8, sz);
+	RESIZE (interpolationListBox, 1130, 62, 90, 20, sz);
+	interpolationListBox.resizeListBox (BUtilities::Point (90 * sz, 60 * sz));
+	interpolationListBox.resizeListBoxItems (BUtilities::Point (90 * sz, 20 * sz));
+	RESIZE (monoLabel, 1030, 52, 90, 8, sz);
+	RESIZE (monoListBox, 1030, 62, 90, 20, sz);
+	monoListBox.resizeListBox (BUtilities::Point (90 * sz, 60 * sz));
+	monoListBox.resizeListBoxItems (BUtilities::Point (90 * sz, 20 * sz));
 
 	RESIZE (settingsContainer, 10, 90, 1220, 40, sz);
 	RESIZE (playButton, 8, 8, 24, 24, sz);
@@ -1128,10 +1158,15 @@ void BOopsGUI::resize ()
 
 void BOopsGUI::applyTheme (BStyles::Theme& theme)
 {
+	invalidatePads ();
 	mContainer.applyTheme (theme);
 	messageLabel.applyTheme (theme);
 	helpButton.applyTheme (theme);
 	ytButton.applyTheme (theme);
+	interpolationLabel.applyTheme (theme);
+	interpolationListBox.applyTheme (theme);
+	monoLabel.applyTheme (theme);
+	monoListBox.applyTheme (theme);
 
 	settingsContainer.applyTheme (theme);
 	playButton.applyTheme (theme);
@@ -1245,6 +1280,16 @@ void BOopsGUI::applyTheme (BStyles::Theme& theme)
 		if (s.optionWidget) s.optionWidget->applyTheme (theme);
 	};
 
+	// Defer theme application for hidden option panels
+	for (int i = 0; i < NR_FX; ++i) optionPanelThemed[i] = false;
+	for (SlotParam& s : slotParams)
+	{
+		for (int i = 0; i < NR_FX; ++i)
+		{
+			if (s.optionWidget && (s.optionWidget == optionPanels[i])) optionPanelThemed[i] = true;
+		}
+	}
+
 	shapeEditor.container.applyTheme (theme);
 	shapeEditor.shapeWidget.applyTheme (theme);
 	shapeEditor.cancelButton.applyTheme (theme);
@@ -2274,8 +2319,18 @@ void BOopsGUI::updateSlots ()
 
 void BOopsGUI::gotoSlot (const int slot)
 {
+	const int oldSlot = actSlot;
 	actSlot = slot;
 	const int slotSize = getSlotsSize();
+
+	// Move the shared option panel to the new slot
+	if ((oldSlot != slot) && (oldSlot >= 0) && (oldSlot < NR_SLOTS)) setOptionWidget (oldSlot);
+	if ((slot >= 0) && (slot < NR_SLOTS) && ((oldSlot != slot) || (!slotParams[slot].optionWidget)))
+	{
+		setOptionWidget (slot);
+		loadOptions (slot);
+	}
+
 	for (int i = 0; i < NR_SLOTS; ++i)
 	{
 		if ((i == slot) && (i < slotSize))
@@ -2310,118 +2365,144 @@ void BOopsGUI::gotoSlot (const int slot)
 	sendEditorSlot();
 }
 
-void BOopsGUI::setOptionWidget (const int slot)
+OptionWidget* BOopsGUI::getOptionPanel (const int fxnr)
 {
-	// Firstly delete old optionWidget
-	if (slotParams[slot].optionWidget)
-	{
-		delete slotParams[slot].optionWidget;
-		slotParams[slot].optionWidget = nullptr;
-	}
-
-	// Create new optionWidget
-	const double v = slots[slot].container.getValue();
-	const int fxnr = ((v >= FX_NONE) && (v < NR_FX) ? v : FX_NONE);
+	if ((fxnr < 0) || (fxnr >= NR_FX)) return nullptr;
+	if (optionPanels[fxnr]) return optionPanels[fxnr];
 
+	// Build on first use
+	OptionWidget* panel = nullptr;
 	switch (fxnr)
 	{
-		case FX_SURPRISE:	slotParams[slot].optionWidget = new OptionSurprise (270, 20, 640, 130, "widget");
+		case FX_SURPRISE:	panel = new OptionSurprise (270, 20, 640, 130, "widget");
 					break;
 
-		case FX_AMP:		slotParams[slot].optionWidget = new OptionAmp (430, 20, 80, 130, "widget");
+		case FX_AMP:		panel = new OptionAmp (430, 20, 80, 130, "widget");
 					break;
 
-		case FX_BALANCE:	slotParams[slot].optionWidget = new OptionBalance (430, 20, 80, 130, "widget");
+		case FX_BALANCE:	panel = new OptionBalance (430, 20, 80, 130, "widget");
 					break;
 
-		case FX_WIDTH:		slotParams[slot].optionWidget = new OptionWidth (430, 20, 80, 130, "widget");
+		case FX_WIDTH:		panel = new OptionWidth (430, 20, 80, 130, "widget");
 					break;
 
-		case FX_DELAY:		slotParams[slot].optionWidget = new OptionDelay (430, 20, 240, 130, "widget");
+		case FX_DELAY:		panel = new OptionDelay (430, 20, 240, 130, "widget");
 					break;
 
-		case FX_CHOPPER:	slotParams[slot].optionWidget = new OptionChopper (430, 20, 560, 130, "widget");
+		case FX_CHOPPER:	panel = new OptionChopper (430, 20, 560, 130, "widget");
 					break;
 
-		case FX_TAPE_STOP:	slotParams[slot].optionWidget = new OptionTapeStop (430, 20, 160, 130, "widget");
+		case FX_TAPE_STOP:	panel = new OptionTapeStop (430, 20, 160, 130, "widget");
 					break;
 
-		case FX_TAPE_SPEED:	slotParams[slot].optionWidget = new OptionTapeSpeed (430, 20, 80, 130, "widget");
+		case FX_TAPE_SPEED:	panel = new OptionTapeSpeed (430, 20, 80, 130, "widget");
 					break;
 
-		case FX_SCRATCH:	slotParams[slot].optionWidget = new OptionScratch (430, 20, 480, 130, "widget", pluginPath);
-					if (slotParams[slot].optionWidget) ((OptionScratch*)slotParams[slot].optionWidget)->setShape (slotParams[slot].shape);
+		case FX_SCRATCH:	panel = new OptionScratch (430, 20, 480, 130, "widget", pluginPath);
 					break;
 
-		case FX_WOWFLUTTER:	slotParams[slot].optionWidget = new OptionWowFlutter (430, 20, 320, 130, "widget");
+		case FX_WOWFLUTTER:	panel = new OptionWowFlutter (430, 20, 320, 130, "widget");
 					break;
 
-		case FX_BITCRUSH:	slotParams[slot].optionWidget = new OptionBitcrush (430, 20, 160, 130, "widget");
+		case FX_BITCRUSH:	panel = new OptionBitcrush (430, 20, 160, 130, "widget");
 					break;
 
-		case FX_DECIMATE:	slotParams[slot].optionWidget = new OptionDecimate (430, 20, 80, 130, "widget");
+		case FX_DECIMATE:	panel = new OptionDecimate (430, 20, 80, 130, "widget");
 					break;
 
-		case FX_DISTORTION:	slotParams[slot].optionWidget = new OptionDistortion (430, 20, 240, 130, "widget");
+		case FX_DISTORTION:	panel = new OptionDistortion (430, 20, 240, 130, "widget");
 					break;
 
-		case FX_FILTER:		slotParams[slot].optionWidget = new OptionFilter (430, 20, 240, 130, "widget");
+		case FX_FILTER:		panel = new OptionFilter (430, 20, 240, 130, "widget");
 					break;
 
-		case FX_NOISE:		slotParams[slot].optionWidget = new OptionNoise (430, 20, 80, 130, "widget");
+		case FX_NOISE:		panel = new OptionNoise (430, 20, 80, 130, "widget");
 					break;
 
-		case FX_CRACKLES:	slotParams[slot].optionWidget = new OptionCrackles (430, 20, 320, 130, "widget");
+		case FX_CRACKLES:	panel = new OptionCrackles (430, 20, 320, 130, "widget");
 					break;
 
-		case FX_STUTTER:	slotParams[slot].optionWidget = new OptionStutter (430, 20, 160, 130, "widget");
+		case FX_STUTTER:	panel = new OptionStutter (430, 20, 160, 130, "widget");
 					break;
 
-		case FX_FLANGER:	slotParams[slot].optionWidget = new OptionFlanger (430, 20, 400, 130, "widget");
+		case FX_FLANGER:	panel = new OptionFlanger (430, 20, 400, 130, "widget");
 					break;
 
-		case FX_PHASER:		slotParams[slot].optionWidget = new OptionPhaser (430, 20, 480, 130, "widget");
+		case FX_PHASER:		panel = new OptionPhaser (430, 20, 480, 130, "widget");
 					break;
 
-		case FX_RINGMOD:	slotParams[slot].optionWidget = new OptionRingModulator (430, 20, 260, 130, "widget");
+		case FX_RINGMOD:	panel = new OptionRingModulator (430, 20, 260, 130, "widget");
 					break;
 
-		case FX_OOPS:		slotParams[slot].optionWidget = new OptionOops (430, 20, 240, 130, "widget");
+		case FX_OOPS:		panel = new OptionOops (430, 20, 240, 130, "widget");
 					break;
 
-		case FX_WAH:		slotParams[slot].optionWidget = new OptionWah (430, 20, 720, 130, "widget", pluginPath);
-							if (slotParams[slot].optionWidget) ((OptionWah*)slotParams[slot].optionWidget)->setShape (slotParams[slot].shape);
+		case FX_WAH:		panel = new OptionWah (430, 20, 720, 130, "widget", pluginPath);
 							break;
 
-		case FX_REVERB:		slotParams[slot].optionWidget = new OptionReverb (430, 20, 80, 130, "widget");
+		case FX_REVERB:		panel = new OptionReverb (430, 20, 80, 130, "widget");
 					break;
 
-		case FX_GALACTIC:	slotParams[slot].optionWidget = new OptionGalactic (430, 20, 320, 130, "widget");
+		case FX_GALACTIC:	panel = new OptionGalactic (430, 20, 320, 130, "widget");
 					break;
 
-		case FX_INFINITY:	slotParams[slot].optionWidget = new OptionInfinity (430, 20, 400, 130, "widget");
+		case FX_INFINITY:	panel = new OptionInfinity (430, 20, 400, 130, "widget");
 					break;
 
-		case FX_TREMOLO:	slotParams[slot].optionWidget = new OptionTremolo (430, 20, 260, 130, "widget");
+		case FX_TREMOLO:	panel = new OptionTremolo (430, 20, 260, 130, "widget");
 					break;
 
-		case FX_WAVESHAPER:	slotParams[slot].optionWidget = new OptionWaveshaper (430, 20, 400, 130, "widget", pluginPath);
-							if (slotParams[slot].optionWidget) ((OptionWah*)slotParams[slot].optionWidget)->setShape (slotParams[slot].shape);
+		case FX_WAVESHAPER:	panel = new OptionWaveshaper (430, 20, 400, 130, "widget", pluginPath);
 							break;
 
-		case FX_TESLACOIL:	slotParams[slot].optionWidget = new OptionTeslaCoil (430, 20, 160, 130, "widget");
+		case FX_TESLACOIL:	panel = new OptionTeslaCoil (430, 20, 160, 130, "widget");
 							break;
 
-		case FX_BANGER:		slotParams[slot].optionWidget = new OptionBanger (430, 20, 480, 130, "widget");
+		case FX_BANGER:		panel = new OptionBanger (430, 20, 480, 130, "widget");
 							break;
 
-		case FX_EQ:			slotParams[slot].optionWidget = new OptionEQ (430, 20, 720, 130, "widget");
+		case FX_EQ:			panel = new OptionEQ (430, 20, 720, 130, "widget");
 							break;
 
-		default:			slotParams[slot].optionWidget = new OptionWidget (0, 0, 0, 0, "widget");
+		default:			panel = new OptionWidget (0, 0, 0, 0, "widget");
+	}
+
+	optionPanels[fxnr] = panel;
+	optionPanelThemed[fxnr] = false;
+	return panel;
+}
+
+void BOopsGUI::setOptionWidget (const int slot)
+{
+	// Firstly detach old optionWidget
+	if (slotParams[slot].optionWidget)
+	{
+		slotParams[slot].container.release (slotParams[slot].optionWidget);
+		slotParams[slot].optionWidget = nullptr;
+	}
+
+	// Only the shown slot holds an option panel
+	if (slot != actSlot) return;
+
+	// Attach the option panel for the slot effect
+	const double v = slots[slot].container.getValue();
+	const int fxnr = ((v >= FX_NONE) && (v < NR_FX) ? v : FX_NONE);
+
+	// Release from a previous slot
+	OptionWidget* panel = getOptionPanel (fxnr);
+	for (SlotParam& s : slotParams)
+	{
+		if (s.optionWidget && (s.optionWidget == panel))
+		{
+			s.container.release (s.optionWidget);
+			s.optionWidget = nullptr;
+		}
 	}
 
-	if (slotParams[slot].optionWidget) slotParams[slot].optionWidget->zoom (sz);
+	slotParams[slot].optionWidget = panel;
+	if (!panel) return;
+
+	panel->zoom (sz);
 }
 
 void BOopsGUI::loadOptions (const int slot)
@@ -2430,6 +2511,7 @@ void BOopsGUI::loadOptions (const int slot)
 	if (slotParams[slot].optionWidget)
 	{
 		slotParams[slot].container.add (*slotParams[slot].optionWidget);
+		slotParams[slot].optionWidget->show ();
 
 		// Load values
 		for (int i = 0; i < NR_OPTPARAMS; ++i)
@@ -2441,13 +2523,29 @@ void BOopsGUI::loadOptions (const int slot)
 		slotParams[slot].optionWidget->setShape (slotParams[slot].shape);
 
 		// Load styles
+		const std::string padName = slotParams[slot].adsrDisplay.getName();
+		bool renamed = false;
 		std::vector<Widget*> children = slotParams[slot].optionWidget->getChildren();
 		for (Widget* w : children)
 		{
 			if (w)
 			{
 				const std::string name = w->getName();
-				if (name.substr (0, 3) == "pad") w->rename (slotParams[slot].adsrDisplay.getName());
+				if ((name.substr (0, 3) == "pad") && (name != padName))
+				{
+					w->rename (padName);
+					renamed = true;
+				}
+			}
+		}
+
+		// Theme the shared panel if stale or renamed for this slot's pad
+		for (int i = 0; i < NR_FX; ++i)
+		{
+			if ((optionPanels[i] == slotParams[slot].optionWidget) && (renamed || (!optionPanelThemed[i])))
+			{
+				slotParams[slot].optionWidget->applyTheme (theme);
+				optionPanelThemed[i] = true;
 			}
 		}
 	}
@@ -2588,6 +2686,9 @@ void BOopsGUI::valueChangedCallback(BEvents::Event* event)
 						ui->drawPad();
 						break;
 
+			case INTERPOLATION:
+			case FORCE_MONO:	break;
+
 			default:		if (controllerNr >= SLOTS)
 						{
 							int slot = (controllerNr - SLOTS) / (SLOTS_PARAMS + NR_PARAMS);
@@ -2639,9 +2740,10 @@ void BOopsGUI::valueChangedCallback(BEvents::Event* event)
 											(fxDefaultValues[fxnr][i]);
 										}
 
-										if (ui->slotParams[slot].optionWidget) 
+										OptionWidget* panel = ui->getOptionPanel (fxnr);
+										if (panel)
 										{
-											ui->slotParams[slot].shape = ui->slotParams[slot].optionWidget->getDefaultShape();
+											ui->slotParams[slot].shape = panel->getDefaultShape();
 											ui->sendShape (slot);
 										}
 									}
@@ -4371,86 +4473,169 @@ void BOopsGUI::setPad (const int page, const int slot, const int step, const Pad
 
 void BOopsGUI::drawPad ()
 {
+	for (std::array<bool, NR_STEPS>& r : padDirty) r.fill (true);
+	padsDirty = true;
+}
+
+void BOopsGUI::drawPad (const int slot)
+{
+	if ((slot < 0) || (slot >= NR_SLOTS)) return;
+	for (PadTile& t : padTiles[slot]) t.valid = false;
+	padDirty[slot].fill (true);
+	padsDirty = true;
+}
+
+void BOopsGUI::drawPad (const int row, const int step)
+{
+	if ((row < 0) || (row >= NR_SLOTS) || (step < 0) || (step >= NR_STEPS)) return;
+	padTiles[row][step].valid = false;
+	padDirty[row][step] = true;
+	padsDirty = true;
+}
+
+void BOopsGUI::invalidatePads ()
+{
+	for (std::array<PadTile, NR_STEPS>& r : padTiles) for (PadTile& t : r) t.valid = false;
+	drawPad ();
+	padsFullRedraw = true;
+}
+
+void BOopsGUI::flushPads ()
+{
+	if (!padsDirty) return;
+
 	cairo_surface_t* surface = padSurface.getDrawingSurface();
 	cairo_t* cr = cairo_create (surface);
-	int maxstep = controllerWidgets[STEPS]->getValue ();
+	const int maxstep = LIMIT (controllerWidgets[STEPS]->getValue (), 1, NR_STEPS);
+
 	for (int row = 0; row < NR_SLOTS; ++row)
 	{
+		std::array<bool, NR_STEPS>& dirty = padDirty[row];
+		if (std::find (dirty.begin(), dirty.end(), true) == dirty.end()) continue;
+
+		const int fxnr = slots[row].container.getValue();
+		const bool keysMode = patterns[pageAct].getKey(row, NR_PIANO_KEYS);
+		const bool shapeMode = (!keysMode) && (patterns[pageAct].getShape (row).size () != 0);
+		slots[row].shapePad.setSymbol (keysMode ? MIDISYMBOL : (shapeMode ? SHAPESYMBOL : PATTERNSYMBOL));
+
 		// Empty slot
-		if ((slots[row].container.getValue() == FX_NONE) || (slots[row].container.getValue() == FX_INVALID))
+		if ((fxnr == FX_NONE) || (fxnr == FX_INVALID))
 		{
-			for (int step = 0; step < maxstep; ++step) drawPad (cr, row, step);
+			for (int step = 0; step < maxstep; ++step)
+			{
+				if (dirty[step]) drawPad (cr, row, step);
+			}
 		}
 
 		// Keys or shape mode
-		else if (patterns[pageAct].getKey(row, NR_PIANO_KEYS) || (patterns[pageAct].getShape (row) != Shape<SHAPE_MAXNODES>())) drawPad (cr, row, 0);
+		else if (keysMode || shapeMode) drawPad (cr, row, 0);
 
-		// Pattern mode
+		// Pattern mode: redraw each pad covering a dirty cell
 		else
 		{
-			for (int step = 0; step < maxstep; step += (patterns[pageAct].getPad (row, step).size > 1 ? patterns[pageAct].getPad (row, step).size : 1))
+			for (int step = 0; step < maxstep; )
 			{
-				drawPad (cr, row, step);
+				const int ps = LIMIT (int (patterns[pageAct].getPad (row, step).size), 1, maxstep - step);
+				if (std::find (dirty.begin() + step, dirty.begin() + step + ps, true) != dirty.begin() + step + ps) drawPad (cr, row, step);
+				step += ps;
 			}
 		}
+
+		dirty.fill (false);
 	}
 
 	cairo_destroy (cr);
-	padSurface.update();
-}
+	padsDirty = false;
 
-void BOopsGUI::drawPad (const int slot)
-{
-	cairo_surface_t* surface = padSurface.getDrawingSurface();
-	cairo_t* cr = cairo_create (surface);
-	int maxstep = controllerWidgets[STEPS]->getValue ();
-
-	// Empty slot
-	if ((slots[slot].container.getValue() == FX_NONE) || (slots[slot].container.getValue() == FX_INVALID))
+	if (padsFullRedraw)
 	{
-		for (int step = 0; step < maxstep; ++step) drawPad (cr, slot, step);
+		padsFullRedraw = false;
+		for (BUtilities::RectArea& a : padDamage) a = BUtilities::RectArea ();
+		padSurface.update();
+		return;
 	}
 
-	// Keys or shape mode
-	else if (patterns[pageAct].getKey(slot, NR_PIANO_KEYS) || (patterns[pageAct].getShape (slot) != Shape<SHAPE_MAXNODES>())) drawPad (cr, slot, 0);
-
-	// Pattern mode
-	else
+	for (BUtilities::RectArea& a : padDamage)
 	{
-		for (int step = 0; step < maxstep; step += (patterns[pageAct].getPad (slot, step).size > 1 ? patterns[pageAct].getPad (slot, step).size : 1))
-		{
-			drawPad (cr, slot, step);
-		}
+		if (a != BUtilities::RectArea ()) padSurface.updateArea (a);
+		a = BUtilities::RectArea ();
 	}
-
-	cairo_destroy (cr);
-	padSurface.update();
 }
 
-void BOopsGUI::drawPad (const int row, const int step)
+static uint32_t hashPadContent (uint32_t hash, const void* data, const size_t size)
 {
-	cairo_surface_t* surface = padSurface.getDrawingSurface();
-	cairo_t* cr = cairo_create (surface);
-	drawPad (cr, row, step);
-	cairo_destroy (cr);
-	padSurface.update();
+	// FNV-1a
+	const uint8_t* d = static_cast<const uint8_t*> (data);
+	for (size_t i = 0; i < size; ++i) hash = (hash ^ d[i]) * 16777619u;
+	return hash;
 }
 
 void BOopsGUI::drawPad (cairo_t* cr, const int row, const int step)
 {
-	const int fxnr = LIMIT (slots[row].container.getValue(), FX_NONE, NR_FX - 1);
-	Shape<SHAPE_MAXNODES> sh = patterns[pageAct].getShape (row);
-	SymbolIndex mode = (patterns[pageAct].getKey(row, NR_PIANO_KEYS) ? MIDISYMBOL : (sh != Shape<SHAPE_MAXNODES>())? SHAPESYMBOL : PATTERNSYMBOL);
-	int maxstep = controllerWidgets[STEPS]->getValue ();
 	if ((!cr) || (cairo_status (cr) != CAIRO_STATUS_SUCCESS) || (row < 0) || (row >= NR_SLOTS)) return;
 
-	slots[row].shapePad.setSymbol (mode);
+	const int fxnr = LIMIT (slots[row].container.getValue(), FX_NONE, NR_FX - 1);
+	const Shape<SHAPE_MAXNODES>& sh = patterns[pageAct].getShape (row);
+	SymbolIndex mode = (patterns[pageAct].getKey(row, NR_PIANO_KEYS) ? MIDISYMBOL : (sh.size () != 0) ? SHAPESYMBOL : PATTERNSYMBOL);
+	int maxstep = LIMIT (controllerWidgets[STEPS]->getValue (), 1, NR_STEPS);
 	if ((step < 0) || (step >= maxstep)) return;
 
 	// Get origin and size of pad data
 	const int p0 = ((fxnr == FX_NONE) || (fxnr == FX_INVALID) ? step : (mode == PATTERNSYMBOL ? getPadOrigin (pageAct, row, step) : 0));
 	const Pad pd = ((fxnr == FX_NONE) || (fxnr == FX_INVALID) ? Pad (0, 1, 0) : (mode == PATTERNSYMBOL ? patterns[pageAct].getPad (row, p0) : Pad (0, maxstep - p0, 0)));
 	const int ps = LIMIT (pd.size, 1.0, maxstep - p0);
+	const int ic = cursor;
+	const bool empty = ((fxnr == FX_NONE) || (fxnr == FX_INVALID));
+
+	// Clipboard selection
+	int clipRMin = clipBoard.origin.first;
+	int clipRMax = clipBoard.origin.first + clipBoard.extends.first;
+	if (clipRMin > clipRMax) std::swap (clipRMin, clipRMax);
+	int clipSMin = clipBoard.origin.second;
+	int clipSMax = clipBoard.origin.second + clipBoard.extends.second;
+	if (clipSMin > clipSMax) std::swap (clipSMin, clipSMax);
+	const bool selected = ((!clipBoard.ready) && (row >= clipRMin) && (row <= clipRMax) && (p0 >= clipSMin) && (p0 <= clipSMax));
+
+	// Compare with the tiles already drawn
+	PadTile tile;
+	tile.valid = true;
+	tile.page = pageAct;
+	tile.fxnr = fxnr;
+	tile.mode = mode;
+	tile.origin = p0;
+	tile.size = ps;
+	tile.maxstep = maxstep;
+	tile.mix = pd.mix;
+	tile.gate = pd.gate;
+	tile.active = (actSlot == row);
+	tile.selected = selected;
+	tile.cursor = ((mode == SHAPESYMBOL) && (!empty) ? ic : int ((p0 <= ic) && (p0 + ps > ic) && ((mode == PATTERNSYMBOL) || empty)));
+	tile.content = 2166136261u;
+	if ((mode == SHAPESYMBOL) && (!empty))
+	{
+		for (size_t i = 0; i < sh.size (); ++i)
+		{
+			const Node n = sh.getRawNode (i);
+			const double v[7] = {double (n.nodeType), n.point.x, n.point.y, n.handle1.x, n.handle1.y, n.handle2.x, n.handle2.y};
+			tile.content = hashPadContent (tile.content, v, sizeof (v));
+		}
+	}
+	else if ((mode == MIDISYMBOL) && (!empty))
+	{
+		for (int i = 0; i < NR_PIANO_KEYS; ++i)
+		{
+			const uint8_t k = patterns[pageAct].getKey (row, i);
+			tile.content = hashPadContent (tile.content, &k, 1);
+		}
+	}
+
+	bool unchanged = true;
+	for (int i = p0; i < p0 + ps; ++i)
+	{
+		if (!(padTiles[row][i] == tile)) unchanged = false;
+		padTiles[row][i] = tile;
+	}
+	if (unchanged) return;
 
 	// Get size of drawing area
 	const double width = padSurface.getEffectiveWidth ();
@@ -4464,7 +4649,6 @@ void BOopsGUI::drawPad (cairo_t* cr, const int row, const int step)
 	const double yr = round (y);
 	const double wr = round (x + w) - xr;
 	const double hr = round (y + h) - yr;
-	const int ic = cursor;
 
 	// Draw background
 	// Odd or even?
@@ -4472,13 +4656,7 @@ void BOopsGUI::drawPad (cairo_t* cr, const int row, const int step)
 	if (actSlot == row) bg.applyBrightness (0.2);
 
 	// Highlight selection
-	int clipRMin = clipBoard.origin.first;
-	int clipRMax = clipBoard.origin.first + clipBoard.extends.first;
-	if (clipRMin > clipRMax) std::swap (clipRMin, clipRMax);
-	int clipSMin = clipBoard.origin.second;
-	int clipSMax = clipBoard.origin.second + clipBoard.extends.second;
-	if (clipSMin > clipSMax) std::swap (clipSMin, clipSMax);
-	if ((!clipBoard.ready) && (row >= clipRMin) && (row <= clipRMax) && (step >= clipSMin) && (step <= clipSMax)) bg.applyBrightness (0.75);
+	if (selected) bg.applyBrightness (0.75);
 
 	cairo_set_source_rgba (cr, CAIRO_RGBA (bg));
 	cairo_set_line_width (cr, 0.0);
@@ -4489,7 +4667,7 @@ void BOopsGUI::drawPad (cairo_t* cr, const int row, const int step)
 	BColors::Color color = *padColors[fxnr].getColor(BColors::NORMAL);
 	BColors::Color pc = color;
 	pc.applyBrightness (pd.mix - 1.0);
-	if ((p0 <= ic) && (p0 + ps > ic) && ((mode == PATTERNSYMBOL) || (fxnr == FX_NONE) || (fxnr == FX_INVALID))) pc.applyBrightness (0.75);
+	if ((p0 <= ic) && (p0 + ps > ic) && ((mode == PATTERNSYMBOL) || empty)) pc.applyBrightness (0.75);
 	drawButton (cr, xr + 1, yr + 1, wr - 2, hr - 2, pc);
 
 	// Draw label
@@ -4541,6 +4719,8 @@ void BOopsGUI::drawPad (cairo_t* cr, const int row, const int step)
 		slotPianos[row].show();
 	}
 	else slotPianos[row].hide();
+
+	padDamage[row].extend (BUtilities::RectArea (xr, yr, wr, hr));
 }
 
 
@@ -4611,7 +4791,11 @@ static void port_event(LV2UI_Handle ui, uint32_t port_index, uint32_t buffer_siz
 static int call_idle (LV2UI_Handle ui)
 {
 	BOopsGUI* self = (BOopsGUI*) ui;
-	if (self) self->handleEvents ();
+	if (self)
+	{
+		self->flushPads ();
+		self->handleEvents ();
+	}
 	return 0;
 }
 
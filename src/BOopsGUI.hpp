@@ -153,6 +153,7 @@ public:
 	void deletePage (const int page);
 	void swapPage (const int page1, const int page2);
 	void updatePageContainer ();
+	void flushPads ();
 	virtual void onConfigureRequest (BEvents::ExposeEvent* event) override;
 	virtual void onKeyPressed (BEvents::KeyEvent* event) override;
 	virtual void onKeyReleased (BEvents::KeyEvent* event) override;
@@ -207,6 +208,7 @@ private:
 	void updateSlot (const int slot);
 	void updateSlots ();
 	void gotoSlot (const int slot);
+	OptionWidget* getOptionPanel (const int fxnr);
 	void setOptionWidget (const int slot);
 	void loadOptions (const int slot);
 	void randomizePads ();
@@ -216,6 +218,7 @@ private:
 	void drawPad (const int slot);
 	void drawPad (const int slot, const int step);
 	void drawPad (cairo_t* cr, const int slot, const int step);
+	void invalidatePads ();
 
 	std::string pluginPath;
 	double sz;
@@ -239,6 +242,40 @@ private:
 	//Pads
 	std::array<Pattern, NR_PAGES> patterns;
 
+	// Pad renderer: drawPad () only marks cells dirty, flushPads () redraws
+	// the dirty cells once per frame. Each cell stores the state of the tile
+	// already drawn on padSurface and unchanged tiles are skipped.
+	struct PadTile
+	{
+		bool valid = false;
+		int page;
+		int fxnr;
+		int mode;
+		int origin;
+		int size;
+		int maxstep;
+		float mix;
+		float gate;
+		bool active;
+		bool selected;
+		int cursor;
+		uint32_t content;
+
+		bool operator== (const PadTile& rhs) const
+		{
+			return	valid && rhs.valid && (page == rhs.page) && (fxnr == rhs.fxnr) && (mode == rhs.mode) &&
+				(origin == rhs.origin) && (size == rhs.size) && (maxstep == rhs.maxstep) &&
+				(mix == rhs.mix) && (gate == rhs.gate) && (active == rhs.active) &&
+				(selected == rhs.selected) && (cursor == rhs.cursor) && (content == rhs.content);
+		}
+	};
+
+	std::array<std::array<PadTile, NR_STEPS>, NR_SLOTS> padTiles;
+	std::array<std::array<bool, NR_STEPS>, NR_SLOTS> padDirty;
+	std::array<BUtilities::RectArea, NR_SLOTS> padDamage;
+	bool padsDirty;
+	bool padsFullRedraw;
+
 
 	struct ClipBoard
 	{
@@ -273,6 +310,10 @@ private:
 	BWidgets::Label messageLabel;
 	HaloButton helpButton;
 	HaloButton ytButton;
+	BWidgets::Label interpolationLabel;
+	BWidgets::PopupListBox interpolationListBox;
+	BWidgets::Label monoLabel;
+	BWidgets::PopupListBox monoListBox;
 
 	BWidgets::Widget settingsContainer;
 	HaloToggleButton playButton;
@@ -387,11 +428,16 @@ private:
 		Dial mixDial;
 		std::array<BWidgets::ValueWidget, NR_OPTPARAMS> options;
 		Shape<SHAPE_MAXNODES> shape;
-		OptionWidget* optionWidget;
+		OptionWidget* optionWidget;	// Option panel attached while the slot is shown, or nullptr
 	};
 
 	std::array<SlotParam, NR_SLOTS> slotParams;
 
+	// Option panels, one per effect type, built on first use and shared
+	// by all slots. Themes are applied to a panel when it is shown.
+	std::array<OptionWidget*, NR_FX> optionPanels;
+	std::array<bool, NR_FX> optionPanelThemed;
+
 	BWidgets::ImageIcon gettingstartedContainer;
 	BWidgets::Text gettingstartedText;
 
@@ -0,0 +1,595 @@
+/* B.Oops
+ * Glitch effect sequencer LV2 plugin
+ *
+ * Copyright (C) 2020 by Sven Jähnichen
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Offline renderer. Runs the B.Oops DSP (linked in from BOops.cpp) without
+ * an LV2 host: Loads a preset or a saved state, feeds an input file (or
+ * silence for the sample source mode) block by block and writes the
+ * result to a WAV file. The host features (urid:map, worker:schedule,
+ * state:mapPath) are provided locally. The worker runs synchronously
+ * between two blocks. Thus the output is reproducible.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <stdexcept>
+#include <sndfile.h>
+#include <lv2/lv2plug.in/ns/lv2core/lv2.h>
+#include <lv2/lv2plug.in/ns/ext/atom/atom.h>
+#include <lv2/lv2plug.in/ns/ext/atom/forge.h>
+#include <lv2/lv2plug.in/ns/ext/urid/urid.h>
+#include <lv2/lv2plug.in/ns/ext/time/time.h>
+#include <lv2/lv2plug.in/ns/ext/state/state.h>
+#include <lv2/lv2plug.in/ns/ext/worker/worker.h>
+#include "Definitions.hpp"
+#include "Ports.hpp"
+#include "TurtleState.hpp"
+
+#define RENDER_DEFAULT_BLOCKSIZE 256
+#define RENDER_DEFAULT_SAMPLERATE 48000
+#define RENDER_ATOM_BUFFERSIZE 0x100000
+#define RENDER_DEFAULT_SEED 0
+
+extern "C" const LV2_Descriptor* lv2_descriptor (uint32_t index);
+
+/*
+ * Local host: URID map, synchronous worker and path mapping.
+ */
+struct RenderHost
+{
+	std::map<std::string, LV2_URID> urids;
+	std::vector<std::vector<uint8_t>> requests;
+	std::vector<std::vector<uint8_t>> responses;
+	std::string stateDir;
+
+	static LV2_URID map (LV2_URID_Map_Handle handle, const char* uri)
+	{
+		RenderHost* host = (RenderHost*) handle;
+		std::map<std::string, LV2_URID>::const_iterator it = host->urids.find (uri);
+		if (it != host->urids.end()) return it->second;
+		const LV2_URID urid = host->urids.size() + 1;
+		host->urids[uri] = urid;
+		return urid;
+	}
+
+	static LV2_Worker_Status scheduleWork (LV2_Worker_Schedule_Handle handle, uint32_t size, const void* data)
+	{
+		RenderHost* host = (RenderHost*) handle;
+		host->requests.push_back (std::vector<uint8_t> ((const uint8_t*) data, (const uint8_t*) data + size));
+		return LV2_WORKER_SUCCESS;
+	}
+
+	static LV2_Worker_Status respond (LV2_Worker_Respond_Handle handle, uint32_t size, const void* data)
+	{
+		RenderHost* host = (RenderHost*) handle;
+		host->responses.push_back (std::vector<uint8_t> ((const uint8_t*) data, (const uint8_t*) data + size));
+		return LV2_WORKER_SUCCESS;
+	}
+
+	static char* abstractPath (void* handle, const char* path) {return strdup (path);}
+
+	static char* absolutePath (void* handle, const char* path)
+	{
+		RenderHost* host = (RenderHost*) handle;
+		std::string p = path;
+		if (p.compare (0, 7, "file://") == 0) p = p.substr (7);
+		if ((p != "") && (p[0] != '/') && (host->stateDir != "")) p = host->stateDir + "/" + p;
+		return strdup (p.c_str());
+	}
+
+	// Runs all scheduled work and passes the responses back to the plugin
+	void work (LV2_Handle instance, const LV2_Worker_Interface* worker)
+	{
+		while (!requests.empty())
+		{
+			std::vector<std::vector<uint8_t>> pending;
+			pending.swap (requests);
+			for (std::vector<uint8_t>& r : pending) worker->work (instance, respond, this, r.size(), r.data());
+
+			std::vector<std::vector<uint8_t>> answers;
+			answers.swap (responses);
+			for (std::vector<uint8_t>& r : answers) worker->work_response (instance, r.size(), r.data());
+		}
+	}
+};
+
+/*
+ * State properties for state:restore, converted from Turtle nodes to atom
+ * bodies.
+ */
+struct RenderState
+{
+	struct Property
+	{
+		LV2_URID type;
+		std::vector<uint8_t> data;
+	};
+
+	std::map<LV2_URID, Property> properties;
+
+	static const void* retrieve (LV2_State_Handle handle, uint32_t key, size_t* size, uint32_t* type, uint32_t* flags)
+	{
+		RenderState* state = (RenderState*) handle;
+		std::map<LV2_URID, Property>::const_iterator it = state->properties.find (key);
+		if (it == state->properties.end()) return nullptr;
+		*size = it->second.data.size();
+		*type = it->second.type;
+		*flags = LV2_STATE_IS_POD | LV2_STATE_IS_PORTABLE;
+		return it->second.data.data();
+	}
+
+	template <typename T> void set (LV2_URID key, LV2_URID type, const T value)
+	{
+		Property& p = properties[key];
+		p.type = type;
+		p.data.resize (sizeof (T));
+		memcpy (p.data.data(), &value, sizeof (T));
+	}
+
+	void setString (LV2_URID key, LV2_URID type, const std::string& value)
+	{
+		Property& p = properties[key];
+		p.type = type;
+		p.data.assign (value.begin(), value.end());
+		p.data.push_back (0);
+	}
+
+	void add (LV2_URID_Map* map, const std::string& key, const TurtleState::Node& node)
+	{
+		const LV2_URID k = map->map (map->handle, key.c_str());
+		const std::string xsd = TURTLE_XSD_PREFIX;
+		const std::string atom = TURTLE_ATOM_PREFIX;
+
+		if (node.kind == TurtleState::Node::IRI) setString (k, map->map (map->handle, LV2_ATOM__Path), node.value);
+
+		else if (node.kind == TurtleState::Node::LITERAL)
+		{
+			const std::string& dt = node.datatype;
+			if ((dt == xsd + "int") || (dt == xsd + "integer") || (dt == atom + "Int")) set<int32_t> (k, map->map (map->handle, LV2_ATOM__Int), atoi (node.value.c_str()));
+			else if ((dt == xsd + "long") || (dt == atom + "Long")) set<int64_t> (k, map->map (map->handle, LV2_ATOM__Long), atoll (node.value.c_str()));
+			else if ((dt == xsd + "float") || (dt == xsd + "decimal") || (dt == atom + "Float")) set<float> (k, map->map (map->handle, LV2_ATOM__Float), atof (node.value.c_str()));
+			else if ((dt == xsd + "double") || (dt == atom + "Double")) set<double> (k, map->map (map->handle, LV2_ATOM__Double), atof (node.value.c_str()));
+			else if ((dt == xsd + "boolean") || (dt == atom + "Bool")) set<int32_t> (k, map->map (map->handle, LV2_ATOM__Bool), node.value == "true");
+			else if (dt == atom + "Path") setString (k, map->map (map->handle, LV2_ATOM__Path), node.value);
+			else setString (k, map->map (map->handle, LV2_ATOM__String), node.value);
+		}
+
+		// Vectors: [a atom:Vector; atom:childType ...; rdf:value (...)]
+		else if (node.kind == TurtleState::Node::BLANK)
+		{
+			const TurtleState::Node* childType = node.get (atom + "childType");
+			const TurtleState::Node* values = node.get (TURTLE_RDF_VALUE);
+			if ((!childType) || (!values)) return;
+
+			Property& p = properties[k];
+			p.type = map->map (map->handle, LV2_ATOM__Vector);
+			LV2_Atom_Vector_Body body;
+			body.child_type = map->map (map->handle, childType->value.c_str());
+			const bool isFloat = (childType->value == atom + "Float");
+			const bool isLong = (childType->value == atom + "Long");
+			body.child_size = (isLong ? sizeof (int64_t) : sizeof (int32_t));
+			p.data.assign ((const uint8_t*) &body, (const uint8_t*) &body + sizeof (body));
+
+			for (const TurtleState::Node& v : values->items)
+			{
+				uint8_t buf[8];
+				if (isFloat) {const float f = atof (v.value.c_str()); memcpy (buf, &f, sizeof (f));}
+				else if (isLong) {const int64_t l = atoll (v.value.c_str()); memcpy (buf, &l, sizeof (l));}
+				else {const int32_t i = atoi (v.value.c_str()); memcpy (buf, &i, sizeof (i));}
+				p.data.insert (p.data.end(), buf, buf + body.child_size);
+			}
+		}
+	}
+};
+
+/*
+ * Port symbol and index pairs plus default values from BOops.ttl.
+ */
+static bool getPorts (const std::string& ttlFile, std::map<std::string, int>& indexes, std::vector<float>& defaults)
+{
+	TurtleState ttl;
+	try {ttl.load (ttlFile);}
+	catch (std::exception& exc)
+	{
+		fprintf (stderr, "BOops-render: %s\n", exc.what());
+		return false;
+	}
+
+	for (const TurtleState::Node& s : ttl.subjects)
+	{
+		for (const std::pair<std::string, TurtleState::Node>& p : s.properties)
+		{
+			if (p.first != TURTLE_LV2_PORT) continue;
+			const TurtleState::Node* symbol = p.second.get (TURTLE_LV2_SYMBOL);
+			const TurtleState::Node* index = p.second.get ("http://lv2plug.in/ns/lv2core#index");
+			const TurtleState::Node* def = p.second.get ("http://lv2plug.in/ns/lv2core#default");
+			if ((!symbol) || (!index)) continue;
+
+			const int i = atoi (index->value.c_str());
+			indexes[symbol->value] = i;
+			if (def && (i >= CONTROLLERS) && (i < CONTROLLERS + NR_CONTROLLERS)) defaults[i - CONTROLLERS] = atof (def->value.c_str());
+		}
+	}
+
+	return true;
+}
+
+static void usage ()
+{
+	fprintf
+	(
+		stderr,
+		"Usage: BOops-render [OPTION]... -o OUTPUT\n"
+		"Renders B.Oops offline.\n\n"
+		"  -p, --preset FILE      preset or saved state (.ttl)\n"
+		"  -i, --input FILE       input audio file (default: silence)\n"
+		"  -s, --sample FILE      use sample source mode with this sample file\n"
+		"  -o, --output FILE      output WAV file\n"
+		"  -t, --tempo BPM        tempo (default: from preset or %.1f)\n"
+		"  -m, --meter BEATS      beats per bar (default: from preset or 4)\n"
+		"  -d, --duration SEC     duration (default: input duration)\n"
+		"  -r, --rate RATE        sample rate without input (default: %i)\n"
+		"  -n, --blocksize N      block size (default: %i)\n"
+		"  -b, --bundle DIR       bundle directory containing BOops.ttl (default: .)\n"
+		"  -c, --set SYMBOL=VALUE set a control port\n"
+		"  -x, --seed N           random seed (default: from state or %i)\n"
+		"  -M, --mono 0|1         downmix the input to mono (default: from state or 0)\n"
+		"  -h, --help             this help\n",
+		120.0, RENDER_DEFAULT_SAMPLERATE, RENDER_DEFAULT_BLOCKSIZE, RENDER_DEFAULT_SEED
+	);
+}
+
+int main (int argc, char** argv)
+{
+	std::string presetFile = "";
+	std::string inputFile = "";
+	std::string sampleFile = "";
+	std::string outputFile = "";
+	std::string bundle = ".";
+	float bpm = 0.0f;
+	float bpb = 0.0f;
+	double duration = -1.0;
+	int samplerate = RENDER_DEFAULT_SAMPLERATE;
+	int blocksize = RENDER_DEFAULT_BLOCKSIZE;
+	int64_t seed = -1;
+	int mono = -1;
+	std::vector<std::pair<std::string, float>> settings;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if ((arg == "-h") || (arg == "--help"))
+		{
+			usage ();
+			return 0;
+		}
+
+		if (i + 1 >= argc)
+		{
+			usage ();
+			return 1;
+		}
+
+		const std::string val = argv[++i];
+		if ((arg == "-p") || (arg == "--preset")) presetFile = val;
+		else if ((arg == "-i") || (arg == "--input")) inputFile = val;
+		else if ((arg == "-s") || (arg == "--sample")) sampleFile = val;
+		else if ((arg == "-o") || (arg == "--output")) outputFile = val;
+		else if ((arg == "-t") || (arg == "--tempo")) bpm = atof (val.c_str());
+		else if ((arg == "-m") || (arg == "--meter")) bpb = atof (val.c_str());
+		else if ((arg == "-d") || (arg == "--duration")) duration = atof (val.c_str());
+		else if ((arg == "-r") || (arg == "--rate")) samplerate = atoi (val.c_str());
+		else if ((arg == "-n") || (arg == "--blocksize")) blocksize = atoi (val.c_str());
+		else if ((arg == "-b") || (arg == "--bundle")) bundle = val;
+		else if ((arg == "-x") || (arg == "--seed")) seed = atoll (val.c_str()) & 0xFFFFFFFF;
+		else if ((arg == "-M") || (arg == "--mono")) mono = (atoi (val.c_str()) != 0);
+		else if ((arg == "-c") || (arg == "--set"))
+		{
+			const size_t eq = val.find ('=');
+			if (eq == std::string::npos)
+			{
+				usage ();
+				return 1;
+			}
+			settings.push_back (std::make_pair (val.substr (0, eq), atof (val.substr (eq + 1).c_str())));
+		}
+		else
+		{
+			usage ();
+			return 1;
+		}
+	}
+
+	if ((outputFile == "") || (blocksize <= 0) || (samplerate <= 0) || (bpb < 0.0f))
+	{
+		usage ();
+		return 1;
+	}
+
+	// Open input
+	SNDFILE* input = nullptr;
+	SF_INFO inputInfo {0, 0, 0, 0, 0, 0};
+	if (inputFile != "")
+	{
+		input = sf_open (inputFile.c_str(), SFM_READ, &inputInfo);
+		if (sf_error (input) != SF_ERR_NO_ERROR)
+		{
+			fprintf (stderr, "BOops-render: Can't open %s: %s\n", inputFile.c_str(), sf_strerror (input));
+			return 1;
+		}
+		samplerate = inputInfo.samplerate;
+		if (duration < 0.0) duration = double (inputInfo.frames) / double (samplerate);
+	}
+
+	if (duration < 0.0)
+	{
+		fprintf (stderr, "BOops-render: Duration required if no input file is given.\n");
+		if (input) sf_close (input);
+		return 1;
+	}
+
+	// Ports
+	std::map<std::string, int> portIndexes;
+	std::vector<float> controllers (NR_CONTROLLERS, 0.0f);
+	if (!getPorts (bundle + "/BOops.ttl", portIndexes, controllers))
+	{
+		if (input) sf_close (input);
+		return 1;
+	}
+
+	// Local host features
+	RenderHost host;
+	LV2_URID_Map map = {&host, RenderHost::map};
+	LV2_Worker_Schedule schedule = {&host, RenderHost::scheduleWork};
+	LV2_State_Map_Path mapPath = {&host, RenderHost::abstractPath, RenderHost::absolutePath};
+	const LV2_Feature mapFeature = {LV2_URID__map, &map};
+	const LV2_Feature scheduleFeature = {LV2_WORKER__schedule, &schedule};
+	const LV2_Feature mapPathFeature = {LV2_STATE__mapPath, &mapPath};
+	const LV2_Feature* features[] = {&mapFeature, &scheduleFeature, &mapPathFeature, nullptr};
+
+	// Load preset / state
+	RenderState state;
+	if (presetFile != "")
+	{
+		TurtleState ttl;
+		try {ttl.load (presetFile);}
+		catch (std::exception& exc)
+		{
+			fprintf (stderr, "BOops-render: %s\n", exc.what());
+			if (input) sf_close (input);
+			return 1;
+		}
+
+		for (const std::pair<const std::string, double>& pv : ttl.getPortValues())
+		{
+			std::map<std::string, int>::const_iterator it = portIndexes.find (pv.first);
+			if ((it != portIndexes.end()) && (it->second >= CONTROLLERS) && (it->second < CONTROLLERS + NR_CONTROLLERS))
+			{
+				controllers[it->second - CONTROLLERS] = pv.second;
+			}
+		}
+
+		const TurtleState::Node* stateNode = ttl.getState ();
+		if (stateNode)
+		{
+			for (const std::pair<std::string, TurtleState::Node>& p : stateNode->properties) state.add (&map, p.first, p.second);
+		}
+
+		const size_t slash = presetFile.find_last_of ('/');
+		host.stateDir = (slash == std::string::npos ? "." : presetFile.substr (0, slash));
+	}
+
+	// Sample source mode
+	if (sampleFile != "")
+	{
+		char buf[PATH_MAX];
+		char* rp = realpath (sampleFile.c_str(), buf);
+		if (!rp)
+		{
+			fprintf (stderr, "BOops-render: Can't find %s.\n", sampleFile.c_str());
+			if (input) sf_close (input);
+			return 1;
+		}
+
+		const LV2_URID startKey = map.map (&host, BOOPS_URI "#sampleStart");
+		const LV2_URID endKey = map.map (&host, BOOPS_URI "#sampleEnd");
+		state.setString (map.map (&host, BOOPS_URI "#samplePath"), map.map (&host, LV2_ATOM__Path), rp);
+		if (state.properties.find (startKey) == state.properties.end()) state.set<int64_t> (startKey, map.map (&host, LV2_ATOM__Long), 0);
+		if (state.properties.find (endKey) == state.properties.end()) state.set<int64_t> (endKey, map.map (&host, LV2_ATOM__Long), INT64_MAX);
+		controllers[SOURCE] = SOURCE_SAMPLE;
+	}
+
+	// Seed. Fixed unless given by the state to get reproducible results.
+	const LV2_URID seedKey = map.map (&host, BOOPS_URI "#seed");
+	if (seed >= 0) state.set<int64_t> (seedKey, map.map (&host, LV2_ATOM__Long), seed);
+	else if (state.properties.find (seedKey) == state.properties.end()) state.set<int64_t> (seedKey, map.map (&host, LV2_ATOM__Long), RENDER_DEFAULT_SEED);
+
+	// Force mono (port and state)
+	if (mono >= 0)
+	{
+		state.set<int32_t> (map.map (&host, BOOPS_URI "#forceMono"), map.map (&host, LV2_ATOM__Bool), mono);
+		controllers[FORCE_MONO] = mono;
+	}
+
+	// Tempo
+	if (bpm > 0.0f) controllers[AUTOPLAY_BPM] = bpm;
+	else bpm = controllers[AUTOPLAY_BPM];
+	if (bpb > 0.0f) controllers[AUTOPLAY_BPB] = bpb;
+	else bpb = controllers[AUTOPLAY_BPB];
+
+	for (const std::pair<std::string, float>& s : settings)
+	{
+		std::map<std::string, int>::const_iterator it = portIndexes.find (s.first);
+		if ((it == portIndexes.end()) || (it->second < CONTROLLERS) || (it->second >= CONTROLLERS + NR_CONTROLLERS))
+		{
+			fprintf (stderr, "BOops-render: Unknown control port %s.\n", s.first.c_str());
+			if (input) sf_close (input);
+			return 1;
+		}
+		controllers[it->second - CONTROLLERS] = s.second;
+	}
+
+	if (controllers[PLAY_MODE] == MIDI_CONTROLLED) fprintf (stderr, "BOops-render: MIDI controlled mode without MIDI input. Nothing will be played.\n");
+
+	// Instantiate
+	const LV2_Descriptor* descriptor = lv2_descriptor (0);
+	const std::string bundlePath = bundle + "/";
+	LV2_Handle instance = descriptor->instantiate (descriptor, samplerate, bundlePath.c_str(), features);
+	if (!instance)
+	{
+		if (input) sf_close (input);
+		return 1;
+	}
+
+	const LV2_Worker_Interface* worker = (const LV2_Worker_Interface*) descriptor->extension_data (LV2_WORKER__interface);
+	const LV2_State_Interface* stateInterface = (const LV2_State_Interface*) descriptor->extension_data (LV2_STATE__interface);
+
+	// Buffers
+	std::vector<float> inputBuffer (blocksize * (inputInfo.channels > 0 ? inputInfo.channels : 1), 0.0f);
+	std::vector<float> audioIn1 (blocksize, 0.0f);
+	std::vector<float> audioIn2 (blocksize, 0.0f);
+	std::vector<float> audioOut1 (blocksize, 0.0f);
+	std::vector<float> audioOut2 (blocksize, 0.0f);
+	std::vector<float> outputBuffer (2 * blocksize, 0.0f);
+	std::vector<uint64_t> controlBuffer (RENDER_ATOM_BUFFERSIZE / sizeof (uint64_t), 0);
+	std::vector<uint64_t> notifyBuffer (RENDER_ATOM_BUFFERSIZE / sizeof (uint64_t), 0);
+	LV2_Atom_Sequence* notify = (LV2_Atom_Sequence*) notifyBuffer.data();
+
+	descriptor->connect_port (instance, CONTROL, controlBuffer.data());
+	descriptor->connect_port (instance, NOTIFY, notifyBuffer.data());
+	descriptor->connect_port (instance, AUDIO_IN_1, audioIn1.data());
+	descriptor->connect_port (instance, AUDIO_IN_2, audioIn2.data());
+	descriptor->connect_port (instance, AUDIO_OUT_1, audioOut1.data());
+	descriptor->connect_port (instance, AUDIO_OUT_2, audioOut2.data());
+	for (int i = 0; i < NR_CONTROLLERS; ++i) descriptor->connect_port (instance, CONTROLLERS + i, &controllers[i]);
+
+	// Restore state before activation
+	if (stateInterface && (!state.properties.empty()))
+	{
+		stateInterface->restore (instance, RenderState::retrieve, &state, LV2_STATE_IS_POD | LV2_STATE_IS_PORTABLE, features);
+		host.work (instance, worker);
+	}
+
+	descriptor->activate (instance);
+
+	// Open output
+	SF_INFO outputInfo {0, samplerate, 2, SF_FORMAT_WAV | SF_FORMAT_FLOAT, 0, 0};
+	SNDFILE* output = sf_open (outputFile.c_str(), SFM_WRITE, &outputInfo);
+	if (sf_error (output) != SF_ERR_NO_ERROR)
+	{
+		fprintf (stderr, "BOops-render: Can't open %s: %s\n", outputFile.c_str(), sf_strerror (output));
+		descriptor->deactivate (instance);
+		descriptor->cleanup (instance);
+		if (input) sf_close (input);
+		return 1;
+	}
+
+	// Transport for host controlled mode
+	LV2_Atom_Forge forge;
+	lv2_atom_forge_init (&forge, &map);
+	const LV2_URID timePosition = map.map (&host, LV2_TIME__Position);
+	const LV2_URID timeBar = map.map (&host, LV2_TIME__bar);
+	const LV2_URID timeBarBeat = map.map (&host, LV2_TIME__barBeat);
+	const LV2_URID timeBpm = map.map (&host, LV2_TIME__beatsPerMinute);
+	const LV2_URID timeBpb = map.map (&host, LV2_TIME__beatsPerBar);
+	const LV2_URID timeSpeed = map.map (&host, LV2_TIME__speed);
+
+	// Render
+	const int64_t frames = duration * samplerate;
+	const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+	for (int64_t frame = 0; frame < frames; frame += blocksize)
+	{
+		const uint32_t n = (frames - frame < blocksize ? frames - frame : blocksize);
+
+		// Input
+		std::fill (audioIn1.begin(), audioIn1.end(), 0.0f);
+		std::fill (audioIn2.begin(), audioIn2.end(), 0.0f);
+		if (input)
+		{
+			const sf_count_t nr = sf_readf_float (input, inputBuffer.data(), n);
+			const int ch = inputInfo.channels;
+			for (sf_count_t i = 0; i < nr; ++i)
+			{
+				audioIn1[i] = inputBuffer[i * ch];
+				audioIn2[i] = inputBuffer[i * ch + (ch > 1 ? 1 : 0)];
+			}
+		}
+
+		// Control sequence (transport in the first block)
+		lv2_atom_forge_set_buffer (&forge, (uint8_t*) controlBuffer.data(), RENDER_ATOM_BUFFERSIZE);
+		LV2_Atom_Forge_Frame seqFrame;
+		lv2_atom_forge_sequence_head (&forge, &seqFrame, 0);
+		if (frame == 0)
+		{
+			LV2_Atom_Forge_Frame objFrame;
+			lv2_atom_forge_frame_time (&forge, 0);
+			lv2_atom_forge_object (&forge, &objFrame, 0, timePosition);
+			lv2_atom_forge_key (&forge, timeBar);
+			lv2_atom_forge_long (&forge, 0);
+			lv2_atom_forge_key (&forge, timeBarBeat);
+			lv2_atom_forge_float (&forge, 0.0f);
+			lv2_atom_forge_key (&forge, timeBpm);
+			lv2_atom_forge_float (&forge, bpm);
+			lv2_atom_forge_key (&forge, timeBpb);
+			lv2_atom_forge_float (&forge, bpb);
+			lv2_atom_forge_key (&forge, timeSpeed);
+			lv2_atom_forge_float (&forge, 1.0f);
+			lv2_atom_forge_pop (&forge, &objFrame);
+		}
+		lv2_atom_forge_pop (&forge, &seqFrame);
+
+		notify->atom.type = 0;
+		notify->atom.size = RENDER_ATOM_BUFFERSIZE;
+
+		descriptor->run (instance, n);
+		host.work (instance, worker);
+
+		// Output
+		for (uint32_t i = 0; i < n; ++i)
+		{
+			outputBuffer[2 * i] = audioOut1[i];
+			outputBuffer[2 * i + 1] = audioOut2[i];
+		}
+		sf_writef_float (output, outputBuffer.data(), n);
+	}
+
+	const double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - t0).count();
+	fprintf
+	(
+		stderr,
+		"BOops-render: %.2f s rendered in %.3f s (%.1f x realtime).\n",
+		duration, seconds, (seconds > 0.0 ? duration / seconds : 0.0)
+	);
+
+	sf_close (output);
+	if (input) sf_close (input);
+	descriptor->deactivate (instance);
+	host.work (instance, worker);
+	descriptor->cleanup (instance);
+	return 0;
+}
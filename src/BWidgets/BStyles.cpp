@@ -172,26 +172,41 @@ cairo_text_extents_t Font::getTextExtents (cairo_t* cr, const std::string& text)
  * Class BStyles::StyleSet
  *****************************************************************************/
 
-StyleSet::StyleSet () {}
-StyleSet::StyleSet (const std::string& name, const std::vector<Style>& styles) : stylesetName (name), styleVector (styles) {}
+StyleSet::StyleSet () : StyleSet ("", {}) {}
+StyleSet::StyleSet (const std::string& name, const std::vector<Style>& styles) :
+	stylesetName (name), styleVector (styles), styleIndex (), usedSet (nullptr)
+{
+	buildIndex ();
+}
+
+void StyleSet::buildIndex ()
+{
+	styleIndex.clear ();
+	usedSet = nullptr;
+	for (size_t i = 0; i < styleVector.size (); ++i)
+	{
+		if (styleVector[i].name == "uses") usedSet = (StyleSet*) styleVector[i].stylePtr;
+		else if (styleIndex.find (styleVector[i].name) == styleIndex.end ()) styleIndex[styleVector[i].name] = i;
+	}
+}
 
 void StyleSet::addStyle (const std::string& styleName, void* ptr)
 {
-	for (Style style : styleVector)
+	std::unordered_map<std::string, size_t>::iterator it = styleIndex.find (styleName);
+	if (it != styleIndex.end ())
 	{
-		if (style.name == styleName)
-		{
-			// Overwrite existing style
-			std::cerr << "Msg from BStyles::StyleSet::addStyle(): Overwrite existing " << stylesetName << "/" << styleName
-					  << "." << std:: endl;
-			style.stylePtr = ptr;
-			return;
-		}
+		// Overwrite existing style
+		std::cerr << "Msg from BStyles::StyleSet::addStyle(): Overwrite existing " << stylesetName << "/" << styleName
+				  << "." << std:: endl;
+		styleVector[it->second].stylePtr = ptr;
+		return;
 	}
 
 	// No hit for styleName? Append style to existing styleset
 	Style newStyle = {styleName, ptr};
 	styleVector.push_back (newStyle);
+	if (styleName == "uses") usedSet = (StyleSet*) ptr;
+	else styleIndex[styleName] = styleVector.size () - 1;
 	return;
 }
 
@@ -203,6 +218,7 @@ void StyleSet::removeStyle (const std::string& styleName)
 		{
 			// Delete existing style
 			styleVector.erase (it);
+			buildIndex ();
 			return;
 		}
 	}
@@ -215,24 +231,13 @@ void StyleSet::removeStyle (const std::string& styleName)
 
 void* StyleSet::getStyle (const std::string& styleName)
 {
-	void* ptr = nullptr;
-	for (Style style : styleVector)
-	{
-		if (style.name == "uses")
-		{
-			StyleSet* usedSet = (StyleSet*) style.stylePtr;
-			ptr = usedSet->getStyle (styleName);
+	std::unordered_map<std::string, size_t>::const_iterator it = styleIndex.find (styleName);
+	if (it != styleIndex.end ()) return styleVector[it->second].stylePtr;
 
-		}
-		if (style.name == styleName)
-		{
-			return ptr = style.stylePtr;
-		}
-	}
-
-	// No hit?
-	// if (!ptr) std::cerr << "Msg from BStyles::StyleSet::getStyle(): " << stylesetName << "/" << styleName << " doesn't exist." << std:: endl;
-	return ptr;
+	// No hit? Try the used StyleSet
+	if (usedSet) return usedSet->getStyle (styleName);
+	// std::cerr << "Msg from BStyles::StyleSet::getStyle(): " << stylesetName << "/" << styleName << " doesn't exist." << std:: endl;
+	return nullptr;
 }
 
 void StyleSet::setName (const std::string& name) {stylesetName = name;}
@@ -246,34 +251,48 @@ std::string StyleSet::getName () const {return stylesetName;}
  * Class BStyles::Theme
  *****************************************************************************/
 
-Theme::Theme () {};
-Theme::Theme (const std::vector<StyleSet>& theme): stylesetVector (theme) {};
+Theme::Theme () : Theme (std::vector<StyleSet> ()) {};
+Theme::Theme (const std::vector<StyleSet>& theme): stylesetVector (theme), stylesetIndex (), resolvedStyles ()
+{
+	buildIndex ();
+};
+
+void Theme::buildIndex ()
+{
+	stylesetIndex.clear ();
+	for (size_t i = 0; i < stylesetVector.size (); ++i)
+	{
+		if (stylesetIndex.find (stylesetVector[i].getName ()) == stylesetIndex.end ()) stylesetIndex[stylesetVector[i].getName ()] = i;
+	}
+	resolvedStyles.clear ();
+}
 
 void Theme::addStyle (const std::string& setName, const std::string& styleName, void* ptr)
 {
-	for (StyleSet styleSet : stylesetVector)
+	resolvedStyles.clear ();
+
+	std::unordered_map<std::string, size_t>::iterator it = stylesetIndex.find (setName);
+	if (it != stylesetIndex.end ())
 	{
-		if (styleSet.getName () == setName)
-		{
-			styleSet.addStyle (styleName, ptr);
-			return;
-		}
+		stylesetVector[it->second].addStyle (styleName, ptr);
+		return;
 	}
 
 	// No hit for styleset? Append styleset to existing theme
 	StyleSet newSet = {setName, {{styleName, ptr}}};
 	stylesetVector.push_back (newSet);
+	stylesetIndex[setName] = stylesetVector.size () - 1;
 }
 
 void Theme::removeStyle (const std::string& setName, const std::string& styleName)
 {
-	for (StyleSet styleSet : stylesetVector)
+	resolvedStyles.clear ();
+
+	std::unordered_map<std::string, size_t>::iterator it = stylesetIndex.find (setName);
+	if (it != stylesetIndex.end ())
 	{
-		if (styleSet.getName () == setName)
-		{
-			styleSet.removeStyle (styleName);
-			return;
-		}
+		stylesetVector[it->second].removeStyle (styleName);
+		return;
 	}
 
 	// No hit?
@@ -284,18 +303,19 @@ void Theme::removeStyle (const std::string& setName, const std::string& styleNam
 
 void* Theme::getStyle (const std::string& setName, const std::string& styleName)
 {
-	for (StyleSet styleSet : stylesetVector)
-	{
-		if (styleSet.getName () == setName)
-		{
-			return styleSet.getStyle (styleName);
-		}
-	}
+	const std::string key = setName + "/" + styleName;
+	std::unordered_map<std::string, void*>::const_iterator rit = resolvedStyles.find (key);
+	if (rit != resolvedStyles.end ()) return rit->second;
+
+	void* ptr = nullptr;
+	std::unordered_map<std::string, size_t>::iterator it = stylesetIndex.find (setName);
+	if (it != stylesetIndex.end ()) ptr = stylesetVector[it->second].getStyle (styleName);
 
 	// No hit?
-	// std::cerr << "Msg from BStyles::Theme::getStyle(): " << setName << "/" << styleName
+	// if (!ptr) std::cerr << "Msg from BStyles::Theme::getStyle(): " << setName << "/" << styleName
 	// 		     << " doesn't exist." << std:: endl;
-	return nullptr;
+	resolvedStyles[key] = ptr;
+	return ptr;
 }
 
 /*
@@ -21,6 +21,8 @@
 #include <stdint.h>
 #include <cstring>
 #include <string>
+#include <vector>
+#include <unordered_map>
 #include <cairo/cairo.h>
 #include "cairoplus.h"
 #include <iostream>
@@ -443,8 +445,12 @@ public:
 	std::string getName () const;
 
 protected:
+	void buildIndex ();
+
 	std::string stylesetName;
 	std::vector<Style> styleVector;
+	std::unordered_map<std::string, size_t> styleIndex;	// Style name -> position in styleVector
+	StyleSet* usedSet;					// Last "uses" style or nullptr
 };
 /*
  * End of class BWidgets::StyleSet
@@ -494,7 +500,15 @@ public:
 	void* getStyle (const std::string& setName, const std::string& styleName);
 
 protected:
+	void buildIndex ();
+
 	std::vector<StyleSet> stylesetVector;
+	std::unordered_map<std::string, size_t> stylesetIndex;	// Set name -> position in stylesetVector
+
+	// Resolved styles ("set/style" -> pointer, including nullptr misses).
+	// Cleared on each change of the theme. Changes of StyleSets
+	// linked via "uses" are not tracked.
+	std::unordered_map<std::string, void*> resolvedStyles;
 };
 /*
  * End of class BWidgets::Theme
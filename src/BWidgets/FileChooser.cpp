@@ -19,6 +19,10 @@
 #include <dirent.h>
 #include <limits.h>
 #include <sys/stat.h>
+#include <ctime>
+#include <map>
+#include <algorithm>
+#include <system_error>
 
 namespace BWidgets
 {
@@ -46,6 +50,7 @@ FileChooser::FileChooser (const double x, const double y, const double width, co
 		dirs (),
 		files (),
 		labels ({"OK", "Open", "Cancel", "File already exists. Overwrite?", "File doesn't exists.", "Create new folder:", "Error: Can't create new folder"}),
+		dirScan (), dirScanVersion (0), scanThreads (), dirListPath (),
 		bgColors (BWIDGETS_DEFAULT_BGCOLORS),
 		pathNameBox (0, 0, 0, 0, name + "/textbox", ""),
 		fileListBox (0, 0, 0, 0, name + "/listbox"),
@@ -147,6 +152,7 @@ FileChooser::FileChooser (const FileChooser& that) :
 	dirs (that.dirs),
 	files (that.files),
 	labels (that.labels),
+	dirScan (), dirScanVersion (0), scanThreads (), dirListPath (that.dirListPath),
 	bgColors (that.bgColors),
 	pathNameBox (that.pathNameBox),
 	fileListBox (that.fileListBox),
@@ -180,14 +186,23 @@ FileChooser::FileChooser (const FileChooser& that) :
 	add (newFolderButton);
 	if (that.confirmBox.getParent ()) add (confirmBox);
 	if (that.createBox.getParent ()) add (createBox);
+	if (that.dirScan) enterDir ();
+}
+
+FileChooser::~FileChooser ()
+{
+	cancelScan ();
+	joinScans (true);
 }
 
 FileChooser& FileChooser::operator= (const FileChooser& that)
 {
+	cancelScan ();
 	filters = that.filters;
 	dirs = that.dirs;
 	files = that.files;
 	labels = that.labels;
+	dirListPath = that.dirListPath;
 	bgColors = that.bgColors;
 	pathNameBox = that.pathNameBox;
 	fileListBox = that.fileListBox;
@@ -213,6 +228,7 @@ FileChooser& FileChooser::operator= (const FileChooser& that)
 	if (that.confirmBox.getParent ()) add (confirmBox);
 	if (that.createBox.getParent ()) add (createBox);
 	ValueWidget::operator= (that);
+	if (that.dirScan) enterDir ();
 	return *this;
 }
 
@@ -238,18 +254,23 @@ void FileChooser::setFileName (const std::string& filename)
 	if (filename != fileNameBox.getText())
 	{
 		fileNameBox.setText (filename);
-		BItems::ItemList* il = fileListBox.getItemList();
-		if (!il) return;
-		for (BItems::Item const& it : *il)
+		selectFileListItem (filename);
+	}
+}
+
+void FileChooser::selectFileListItem (const std::string& filename)
+{
+	BItems::ItemList* il = fileListBox.getItemList();
+	if (!il) return;
+	for (BItems::Item const& it : *il)
+	{
+		if (it.getWidget())
 		{
-			if (it.getWidget())
+			BWidgets::Label* l = (BWidgets::Label*)it.getWidget();
+			if (l->getText() == filename)
 			{
-				BWidgets::Label* l = (BWidgets::Label*)it.getWidget();
-				if (l->getText() == filename)
-				{
-					fileListBox.setValue (it.getValue());
-					break;
-				}
+				fileListBox.setValue (it.getValue());
+				break;
 			}
 		}
 	}
@@ -708,50 +729,222 @@ bool FileChooser::isDir (const std::string& path, const std::string& name) const
 	return false;
 }
 
-void FileChooser::enterDir ()
+namespace
 {
-	std::vector<std::string> newFiles;
+
+struct DirCacheEntry
+{
+	time_t mtime;
+	off_t size;
+	std::vector<std::string> dirs;
+	std::vector<std::string> files;
+};
+
+// Directory listings shared by all FileChoosers, validated by mtime
+std::mutex dirCacheMutex;
+std::map<std::string, DirCacheEntry> dirCache;
+
+bool isDirectory (const std::string& path, const std::string& name)
+{
+	std::string full = (path == PATH_SEPARATOR ? path : path + PATH_SEPARATOR) + name;
+	struct stat sb;
+	if (stat (full.c_str(), &sb)) return false;
+	return S_ISDIR (sb.st_mode);
+}
+
+}
+
+void FileChooser::scanDir (std::shared_ptr<DirScan> scan)
+{
+	const time_t startTime = time (nullptr);
+	struct stat sb;
+	const bool hasStat = (stat (scan->path.c_str(), &sb) == 0);
 	std::vector<std::string> newDirs;
-	DIR *dir = opendir (getPath().c_str());
+	std::vector<std::string> newFiles;
+	size_t nextPublish = BWIDGETS_DEFAULT_FILECHOOSER_SCAN_CHUNK;
 
-	// Scan directory
-	// TODO Use C++17 for future versions
+	DIR *dir = opendir (scan->path.c_str());
 	if (dir)
 	{
-		for (struct dirent* entry = readdir(dir); entry ; entry = readdir(dir))
+		for (struct dirent* entry = readdir(dir); entry && (!scan->cancelled); entry = readdir(dir))
 		{
-			if (isDir (getPath(), entry->d_name))
+			const std::string s = entry->d_name;
+			bool entryIsDir;
+#ifdef DT_DIR
+			// Avoid stat () calls if the file system provides the type
+			if (entry->d_type == DT_DIR) entryIsDir = true;
+			else if (entry->d_type == DT_REG) entryIsDir = false;
+			else
+#endif
+			entryIsDir = isDirectory (scan->path, s);
+
+			// Exclude hidden
+			if (entryIsDir)
 			{
-				std::string s = entry->d_name;
-				if ((std::regex_match (s, std::regex ("(\\.{1,2})|([^\\.].*)"))))	// Exclude hidden
-				{
-					newDirs.push_back (entry->d_name);
-				}
+				if ((s == ".") || (s == "..") || (s[0] != '.')) newDirs.push_back (s);
 			}
 
-			else
-			{
-				std::string s = entry->d_name;
-				if (!std::regex_match (s, std::regex ("\\..*")))	// Exclude hidden
-				{
-					int filterNr = LIMIT ((filterPopupListBox.getValue() - 1), 0, int (filters.size() - 1));
+			else if ((s[0] != '.') && ((!scan->filtered) || std::regex_match (s, scan->regex))) newFiles.push_back (s);
 
-					if  (filters.size() != 0)
-					{
-						if (std::regex_match (s, filters[filterNr].regex)) newFiles.push_back (s);
-					}
-					else newFiles.push_back (s);
-				}
+			// Publish intermediate results at exponentially growing sizes
+			if (newDirs.size() + newFiles.size() >= nextPublish)
+			{
+				std::sort (newFiles.begin(), newFiles.end());
+				std::sort (newDirs.begin(), newDirs.end());
+				std::lock_guard<std::mutex> lock (scan->mutex);
+				scan->dirs = newDirs;
+				scan->files = newFiles;
+				++scan->version;
+				nextPublish *= 2;
 			}
 		}
 		closedir (dir);
 	}
 
-	std::sort (newFiles.begin(), newFiles.end());
-	std::sort (newDirs.begin(), newDirs.end());
+	if (!scan->cancelled)
+	{
+		std::sort (newFiles.begin(), newFiles.end());
+		std::sort (newDirs.begin(), newDirs.end());
+
+		// Cache only if the directory didn't change within this second
+		if (hasStat && (sb.st_mtime < startTime))
+		{
+			std::lock_guard<std::mutex> lock (dirCacheMutex);
+			if (dirCache.size() >= BWIDGETS_DEFAULT_FILECHOOSER_CACHE_SIZE) dirCache.clear();
+			dirCache[scan->cacheKey] = DirCacheEntry {sb.st_mtime, sb.st_size, newDirs, newFiles};
+		}
+
+		std::lock_guard<std::mutex> lock (scan->mutex);
+		scan->dirs.swap (newDirs);
+		scan->files.swap (newFiles);
+		++scan->version;
+		scan->finished = true;
+	}
+
+	scan->done = true;
+}
+
+void FileChooser::enterDir ()
+{
+	const std::string path = getPath();
+	const int filterNr = LIMIT ((filterPopupListBox.getValue() - 1), 0, int (filters.size() - 1));
+	const std::string key = path + "\n" + (filters.size() != 0 ? filters[filterNr].name : "");
+
+	cancelScan ();
+	joinScans (false);
+
+	// Cached and unchanged?
+	struct stat sb;
+	if (stat (path.c_str(), &sb) == 0)
+	{
+		std::vector<std::string> newDirs;
+		std::vector<std::string> newFiles;
+		bool hit = false;
+		{
+			std::lock_guard<std::mutex> lock (dirCacheMutex);
+			std::map<std::string, DirCacheEntry>::const_iterator it = dirCache.find (key);
+			if ((it != dirCache.end()) && (it->second.mtime == sb.st_mtime) && (it->second.size == sb.st_size))
+			{
+				newDirs = it->second.dirs;
+				newFiles = it->second.files;
+				hit = true;
+			}
+		}
+
+		if (hit)
+		{
+			setDirList (newDirs, newFiles);
+			return;
+		}
+	}
+
+	// Clear the list of a previous directory and scan in background
+	if (path != dirListPath) setDirList (std::vector<std::string> (), std::vector<std::string> ());
+
+	dirScan = std::make_shared<DirScan> ();
+	dirScan->path = path;
+	dirScan->cacheKey = key;
+	dirScan->filtered = (filters.size() != 0);
+	if (dirScan->filtered) dirScan->regex = filters[filterNr].regex;
+	dirScanVersion = 0;
+
+	try {scanThreads.push_back (std::make_pair (std::thread (scanDir, dirScan), dirScan));}
+	catch (const std::system_error& err)
+	{
+		// No thread? Scan synchronously
+		scanDir (dirScan);
+	}
+
+	updateIdle ();
+}
+
+void FileChooser::onIdle ()
+{
+	joinScans (false);
+
+	if (!dirScan)
+	{
+		updateIdle ();
+		return;
+	}
+
+	std::vector<std::string> newDirs;
+	std::vector<std::string> newFiles;
+	bool changed = false;
+	bool finished = false;
+	{
+		std::lock_guard<std::mutex> lock (dirScan->mutex);
+		if (dirScan->version != dirScanVersion)
+		{
+			newDirs = dirScan->dirs;
+			newFiles = dirScan->files;
+			dirScanVersion = dirScan->version;
+			changed = true;
+		}
+		finished = dirScan->finished;
+	}
+
+	if (changed) setDirList (newDirs, newFiles);
+	if (finished)
+	{
+		dirScan.reset ();
+		updateIdle ();
+	}
+}
+
+void FileChooser::cancelScan ()
+{
+	if (dirScan)
+	{
+		dirScan->cancelled = true;
+		dirScan.reset ();
+	}
+	updateIdle ();
+}
+
+void FileChooser::updateIdle () {setIdle (dirScan != nullptr);}
+
+void FileChooser::joinScans (const bool all)
+{
+	for (std::vector<std::pair<std::thread, std::shared_ptr<DirScan>>>::iterator it = scanThreads.begin(); it != scanThreads.end(); )
+	{
+		if (all || it->second->done)
+		{
+			if (it->first.joinable ()) it->first.join ();
+			it = scanThreads.erase (it);
+		}
+		else ++it;
+	}
+}
+
+void FileChooser::setDirList (const std::vector<std::string>& newDirs, const std::vector<std::string>& newFiles)
+{
+	const bool samePath = (getPath() == dirListPath);
+	dirListPath = getPath();
 
 	if ((files != newFiles) || (dirs != newDirs))
 	{
+		const int top = fileListBox.getTop ();
 		files = newFiles;
 		dirs = newDirs;
 
@@ -787,7 +980,10 @@ void FileChooser::enterDir ()
 			}
 		}
 
-		fileListBox.setTop (1);
+		fileListBox.setTop (samePath ? top : 1);
+
+		// Keep file selection
+		if (samePath && (getFileName () != "")) selectFileListItem (getFileName ());
 	}
 }
 
@@ -27,6 +27,8 @@
 #define BWIDGETS_DEFAULT_FILECHOOSER_FILE_NOT_EXISTS_INDEX 4
 #define BWIDGETS_DEFAULT_FILECHOOSER_NEW_FOLDER_INDEX 5
 #define BWIDGETS_DEFAULT_FILECHOOSER_NEW_FOLDER_FAIL_INDEX 6
+#define BWIDGETS_DEFAULT_FILECHOOSER_SCAN_CHUNK 256
+#define BWIDGETS_DEFAULT_FILECHOOSER_CACHE_SIZE 32
 
 #ifndef PATH_SEPARATOR
 #define PATH_SEPARATOR "/"
@@ -35,6 +37,10 @@
 #include "PopupListBox.hpp"
 #include "TextButton.hpp"
 #include <regex>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
 
 namespace BWidgets
 {
@@ -67,6 +73,8 @@ public:
 
 	FileChooser (const FileChooser& that);
 
+	~FileChooser ();
+
 	/**
 	 * Assignment. Copies the file chooser properties from a source and keeps
 	 * its position within the widget tree. Emits a
@@ -179,6 +187,12 @@ public:
 	virtual void applyTheme (BStyles::Theme& theme) override;
 	virtual void applyTheme (BStyles::Theme& theme, const std::string& name) override;
 
+	/**
+	 * Takes over the (intermediate) results of a directory scan running
+	 * in the background.
+	 */
+	virtual void onIdle () override;
+
 	static void fileListBoxClickedCallback (BEvents::Event* event);
 	static void filterPopupListBoxClickedCallback (BEvents::Event* event);
 	static void cancelButtonClickedCallback (BEvents::Event* event);
@@ -191,13 +205,46 @@ public:
 
 protected:
 
+	/*
+	 * Directory scan shared between the GUI and a scan thread. The scan
+	 * thread publishes (sorted) intermediate results with an increased
+	 * version number.
+	 */
+	struct DirScan
+	{
+		DirScan () : path (), cacheKey (), filtered (false), regex (), cancelled (false), done (false),
+			     mutex (), dirs (), files (), version (0), finished (false) {}
+
+		std::string path;
+		std::string cacheKey;
+		bool filtered;
+		std::regex regex;
+		std::atomic<bool> cancelled;
+		std::atomic<bool> done;
+		std::mutex mutex;
+		std::vector<std::string> dirs;
+		std::vector<std::string> files;
+		unsigned int version;
+		bool finished;
+	};
+
+	static void scanDir (std::shared_ptr<DirScan> scan);
 	void enterDir ();
+	void setDirList (const std::vector<std::string>& newDirs, const std::vector<std::string>& newFiles);
+	void selectFileListItem (const std::string& filename);
+	void cancelScan ();
+	void joinScans (const bool all);
+	virtual void updateIdle ();
 	void processFileSelected();
 
 	std::vector<FileFilter> filters;
 	std::vector<std::string> dirs;
 	std::vector<std::string> files;
 	std::vector<std::string> labels;
+	std::shared_ptr<DirScan> dirScan;
+	unsigned int dirScanVersion;
+	std::vector<std::pair<std::thread, std::shared_ptr<DirScan>>> scanThreads;
+	std::string dirListPath;
 	BColors::ColorSet bgColors;
 	Label pathNameBox;
 	ListBox fileListBox;
@@ -30,7 +30,7 @@ Widget::Widget (const double x, const double y, const double width, const double
 Widget::Widget(const double x, const double y, const double width, const double height, const std::string& name) :
 		area_ (x, y, width, height),
 		visible_ (true), clickable_ (true), draggable_ (false),
-		scrollable_ (true), focusable_ (true), scheduleDraw_ (false), stacking_ (STACKING_NORMAL),
+		scrollable_ (true), focusable_ (true), scheduleDraw_ (false), idle_ (false), stacking_ (STACKING_NORMAL),
 		main_ (nullptr), parent_ (nullptr), children_ (), border_ (BWIDGETS_DEFAULT_BORDER), background_ (BWIDGETS_DEFAULT_BACKGROUND),
 		name_ (name), widgetSurface_ (), widgetState_ (BWIDGETS_DEFAULT_STATE)
 {
@@ -48,7 +48,7 @@ Widget::Widget(const double x, const double y, const double width, const double
 Widget::Widget (const Widget& that) :
 		area_ (that.area_),
 		visible_ (that.visible_), clickable_ (that.clickable_), draggable_ (that.draggable_), scrollable_ (that.scrollable_),
-		focusable_ (that.focusable_), mergeable_ (that.mergeable_), stacking_ (that.stacking_),
+		focusable_ (that.focusable_), scheduleDraw_ (false), idle_ (false), mergeable_ (that.mergeable_), stacking_ (that.stacking_),
 		main_ (nullptr), parent_ (nullptr), children_ (), border_ (that.border_), background_ (that.background_), name_ (that.name_),
 		cbfunction_ (that.cbfunction_), widgetSurface_ (), widgetState_ (that.widgetState_)
 {
@@ -155,6 +155,7 @@ void Widget::add (Widget& child)
 		forEachChild ([this] (Widget* w)
 		{
 			w->main_ = this->main_;
+			if (w->idle_) this->main_->addIdleWidget (w);
 			w->update ();
 			return true;
 		});
@@ -187,6 +188,7 @@ void Widget::release (Widget* child)
 				if (w->main_)
 				{
 					w->main_->purgeEventQueue (w);
+					w->main_->removeIdleWidget (w);
 					w->main_->getButtonGrabStack()->remove (w);
 					w->main_->getKeyGrabStack()->remove (w);
 					w->main_ = nullptr;
@@ -478,6 +480,18 @@ void Widget::setMergeable (const BEvents::EventType eventType, const bool status
 
 bool Widget::isMergeable (const BEvents::EventType eventType) const {return mergeable_[eventType];}
 
+void Widget::setIdle (const bool status)
+{
+	idle_ = status;
+	if (main_)
+	{
+		if (status) main_->addIdleWidget (this);
+		else main_->removeIdleWidget (this);
+	}
+}
+
+bool Widget::isIdle () const {return idle_;}
+
 void Widget::setStacking (const WidgetStacking stacking) {stacking_ = stacking;}
 
 WidgetStacking Widget::getStacking () const {return stacking_;};
@@ -609,6 +623,8 @@ void Widget::onWheelScrolled (BEvents::WheelEvent* event){cbfunction_[BEvents::E
 void Widget::onValueChanged (BEvents::ValueChangedEvent* event) {cbfunction_[BEvents::EventType::VALUE_CHANGED_EVENT] (event);}
 void Widget::onFocusIn (BEvents::FocusEvent* event) {cbfunction_[BEvents::EventType::FOCUS_IN_EVENT] (event);}
 void Widget::onFocusOut (BEvents::FocusEvent* event) {cbfunction_[BEvents::EventType::FOCUS_OUT_EVENT] (event);}
+void Widget::onIdle () {}
+
 void Widget::onMessage (BEvents::MessageEvent* event) {cbfunction_[BEvents::EventType::MESSAGE_EVENT] (event);}
 
 void Widget::defaultCallback (BEvents::Event* event) {}
@@ -666,11 +682,7 @@ void Widget::postRedisplay ()
 
 void Widget::postRedisplay (const BUtilities::RectArea& area)
 {
-	if (main_)
-	{
-		BEvents::ExposeEvent* event = new BEvents::ExposeEvent (main_, this, BEvents::EXPOSE_REQUEST_EVENT, area);
-		main_->addEventToQueue (event);
-	}
+	if (main_) main_->addExposeDamage (area);
 }
 
 void Widget::postCloseRequest () {postCloseRequest (main_);}
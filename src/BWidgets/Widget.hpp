@@ -481,6 +481,20 @@ public:
 	 */
 	bool isMergeable (const BEvents::EventType eventType) const;
 
+	/**
+	 * Requests (or stops) calls of onIdle () once per event handling
+	 * cycle of the main window. The request is kept if the widget is
+	 * released and added again.
+	 * @param status	TRUE to request idle calls, otherwise FALSE
+	 */
+	void setIdle (const bool status);
+
+	/**
+	 * Gets whether the widget requested idle calls or not.
+	 * @return	TRUE if idle calls are requested, otherwise FALSE
+	 */
+	bool isIdle () const;
+
 	void setStacking (const WidgetStacking stacking);
 
 	WidgetStacking getStacking () const;
@@ -639,6 +653,12 @@ public:
 	 */
 	virtual void onMessage (BEvents::MessageEvent* event);
 
+	/**
+	 * Predefined empty method called once per event handling cycle of the
+	 * main window if requested by setIdle ().
+	 */
+	virtual void onIdle ();
+
 	/**
 	 * Scans theme for widget properties and applies these properties.
 	 * @param theme Theme to be scanned
@@ -686,6 +706,7 @@ protected:
 	bool scrollable_;
 	bool focusable_;
 	bool scheduleDraw_;
+	bool idle_;
 	std::array<bool, BEvents::EventType::NO_EVENT> mergeable_;
 	WidgetStacking stacking_;
 	Window* main_;
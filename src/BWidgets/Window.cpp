@@ -34,7 +34,7 @@ Window::Window (const double width, const double height, const std::string& titl
 		keyGrabStack_ (), buttonGrabStack_ (),
 		title_ (title), world_ (NULL), view_ (NULL), nativeWindow_ (nativeWindow),
 		quit_ (false), focused_ (false), pointer_ (),
-		eventQueue_ ()
+		eventQueue_ (), pendingEvents_ (), exposeDamage_ (), idleWidgets_ ()
 {
 	main_ = this;
 
@@ -67,6 +67,7 @@ Window::~Window ()
 		if (w) release (w);
 	}
 	purgeEventQueue ();
+	idleWidgets_.clear ();
 	keyGrabStack_.clear ();
 	buttonGrabStack_.clear ();
 	puglFreeView (view_);
@@ -120,9 +121,7 @@ void Window::addEventToQueue (BEvents::Event* event)
 	if
 	(
 		(event) &&
-		(event->getWidget()) &&
-		(!eventQueue_.empty ()) &&
-		(eventQueue_.back())
+		(event->getWidget())
 	)
 	{
 		BEvents::EventType eventType = event->getEventType();
@@ -140,108 +139,128 @@ void Window::addEventToQueue (BEvents::Event* event)
 			)
 		)
 		{
-			// Check for mergeable precursor events
-			for (std::deque<BEvents::Event*>::reverse_iterator rit = eventQueue_.rbegin(); rit != eventQueue_.rend(); ++rit)
+			// Check for a mergeable precursor event: the latest pending
+			// event of the same type emitted by the same widget
+			std::map<std::pair<Widget*, BEvents::EventType>, BEvents::Event*>::iterator pit =
+				pendingEvents_.find (std::make_pair (event->getWidget (), eventType));
+			if (pit != pendingEvents_.end ())
 			{
-				BEvents::Event* precursor = *rit;
+				BEvents::Event* precursor = pit->second;
 
-				if ((precursor->getEventType() == eventType) && (event->getWidget () == precursor->getWidget ()))
+				// CONFIGURE_EVENT
+				if (eventType == BEvents::CONFIGURE_REQUEST_EVENT)
 				{
-					// CONFIGURE_EVENT
-					if (eventType == BEvents::CONFIGURE_REQUEST_EVENT)
-					{
-						BEvents::ExposeEvent* firstEvent = (BEvents::ExposeEvent*) precursor;
-						BEvents::ExposeEvent* nextEvent = (BEvents::ExposeEvent*) event;
+					BEvents::ExposeEvent* firstEvent = (BEvents::ExposeEvent*) precursor;
+					BEvents::ExposeEvent* nextEvent = (BEvents::ExposeEvent*) event;
 
-						BUtilities::RectArea area = nextEvent->getArea ();
-						firstEvent->setArea (area);
+					BUtilities::RectArea area = nextEvent->getArea ();
+					firstEvent->setArea (area);
 
-						delete event;
-						return;
-					}
+					delete event;
+					return;
+				}
 
-					// EXPOSE_EVENT
-					if (eventType == BEvents::EXPOSE_REQUEST_EVENT)
-					{
-						BEvents::ExposeEvent* firstEvent = (BEvents::ExposeEvent*) precursor;
-						BEvents::ExposeEvent* nextEvent = (BEvents::ExposeEvent*) event;
+				// EXPOSE_EVENT
+				if (eventType == BEvents::EXPOSE_REQUEST_EVENT)
+				{
+					BEvents::ExposeEvent* firstEvent = (BEvents::ExposeEvent*) precursor;
+					BEvents::ExposeEvent* nextEvent = (BEvents::ExposeEvent*) event;
 
-						BUtilities::RectArea area = firstEvent->getArea ();
-						area.extend (nextEvent->getArea ());
-						firstEvent->setArea (area);
+					BUtilities::RectArea area = firstEvent->getArea ();
+					area.extend (nextEvent->getArea ());
+					firstEvent->setArea (area);
 
-						delete event;
-						return;
-					}
+					delete event;
+					return;
+				}
 
 
-					// POINTER_MOTION_EVENT
-					else if (eventType == BEvents::POINTER_MOTION_EVENT)
-					{
-						BEvents::PointerEvent* firstEvent = (BEvents::PointerEvent*) precursor;
-						BEvents::PointerEvent* nextEvent = (BEvents::PointerEvent*) event;
+				// POINTER_MOTION_EVENT
+				else if (eventType == BEvents::POINTER_MOTION_EVENT)
+				{
+					BEvents::PointerEvent* firstEvent = (BEvents::PointerEvent*) precursor;
+					BEvents::PointerEvent* nextEvent = (BEvents::PointerEvent*) event;
+
+					firstEvent->setPosition (nextEvent->getPosition ());
+					firstEvent->setDelta (firstEvent->getDelta () + nextEvent->getDelta ());
+
+					delete event;
+					return;
+				}
 
+				// POINTER_DRAG_EVENT
+				else if (eventType == BEvents::POINTER_DRAG_EVENT)
+				{
+					BEvents::PointerEvent* firstEvent = (BEvents::PointerEvent*) precursor;
+					BEvents::PointerEvent* nextEvent = (BEvents::PointerEvent*) event;
+
+					if
+					(
+						(nextEvent->getButton() == firstEvent->getButton()) &&
+						(nextEvent->getOrigin() == firstEvent->getOrigin())
+					)
+					{
 						firstEvent->setPosition (nextEvent->getPosition ());
 						firstEvent->setDelta (firstEvent->getDelta () + nextEvent->getDelta ());
 
 						delete event;
 						return;
 					}
+				}
 
-					// POINTER_DRAG_EVENT
-					else if (eventType == BEvents::POINTER_DRAG_EVENT)
-					{
-						BEvents::PointerEvent* firstEvent = (BEvents::PointerEvent*) precursor;
-						BEvents::PointerEvent* nextEvent = (BEvents::PointerEvent*) event;
-
-						if
-						(
-							(nextEvent->getButton() == firstEvent->getButton()) &&
-							(nextEvent->getOrigin() == firstEvent->getOrigin())
-						)
-						{
-							firstEvent->setPosition (nextEvent->getPosition ());
-							firstEvent->setDelta (firstEvent->getDelta () + nextEvent->getDelta ());
-
-							delete event;
-							return;
-						}
-					}
-
-
-					// WHEEL_SCROLL_EVENT
-					else if (eventType == BEvents::WHEEL_SCROLL_EVENT)
-					{
-						BEvents::WheelEvent* firstEvent = (BEvents::WheelEvent*) precursor;
-						BEvents::WheelEvent* nextEvent = (BEvents::WheelEvent*) event;
-
-						if (nextEvent->getPosition() == firstEvent->getPosition())
-						{
-							firstEvent->setDelta (firstEvent->getDelta () + nextEvent->getDelta ());
 
-							delete event;
-							return;
-						}
-					}
+				// WHEEL_SCROLL_EVENT
+				else if (eventType == BEvents::WHEEL_SCROLL_EVENT)
+				{
+					BEvents::WheelEvent* firstEvent = (BEvents::WheelEvent*) precursor;
+					BEvents::WheelEvent* nextEvent = (BEvents::WheelEvent*) event;
 
-					// VALUE_CHANGED_EVENT
-					else if (eventType == BEvents::VALUE_CHANGED_EVENT)
+					if (nextEvent->getPosition() == firstEvent->getPosition())
 					{
-						BEvents::ValueChangedEvent* firstEvent = (BEvents::ValueChangedEvent*) precursor;
-						BEvents::ValueChangedEvent* nextEvent = (BEvents::ValueChangedEvent*) event;
+						firstEvent->setDelta (firstEvent->getDelta () + nextEvent->getDelta ());
 
-						firstEvent->setValue (nextEvent->getValue());
 						delete event;
 						return;
 					}
 				}
+
+				// VALUE_CHANGED_EVENT
+				else if (eventType == BEvents::VALUE_CHANGED_EVENT)
+				{
+					BEvents::ValueChangedEvent* firstEvent = (BEvents::ValueChangedEvent*) precursor;
+					BEvents::ValueChangedEvent* nextEvent = (BEvents::ValueChangedEvent*) event;
+
+					firstEvent->setValue (nextEvent->getValue());
+					delete event;
+					return;
+				}
 			}
+
+			pendingEvents_[std::make_pair (event->getWidget (), eventType)] = event;
 		}
 	}
 
 	eventQueue_.push_back (event);
 }
 
+void Window::addExposeDamage (const BUtilities::RectArea& area)
+{
+	if ((area.getWidth () > 0) && (area.getHeight () > 0)) exposeDamage_.extend (area);
+}
+
+void Window::addIdleWidget (Widget* widget) {if (widget) idleWidgets_.insert (widget);}
+
+void Window::removeIdleWidget (Widget* widget) {idleWidgets_.erase (widget);}
+
+void Window::releasePendingEvent (BEvents::Event* event)
+{
+	if ((!event) || (!event->getWidget ())) return;
+
+	std::map<std::pair<Widget*, BEvents::EventType>, BEvents::Event*>::iterator it =
+		pendingEvents_.find (std::make_pair (event->getWidget (), event->getEventType ()));
+	if ((it != pendingEvents_.end ()) && (it->second == event)) pendingEvents_.erase (it);
+}
+
 BDevices::DeviceGrabStack<uint32_t>* Window::getKeyGrabStack () {return &keyGrabStack_;}
 
 BDevices::DeviceGrabStack<BDevices::MouseDevice>* Window::getButtonGrabStack () {return &buttonGrabStack_;}
@@ -255,6 +274,7 @@ void Window::handleEvents ()
 	{
 		BEvents::Event* event = eventQueue_.front ();
 		eventQueue_.pop_front ();
+		releasePendingEvent (event);
 
 		if (event)
 		{
@@ -397,6 +417,23 @@ void Window::handleEvents ()
 			delete event;
 		}
 	}
+
+	// Idle calls. Widgets may (un)register within onIdle ().
+	if (!idleWidgets_.empty ())
+	{
+		std::vector<Widget*> idleWidgets (idleWidgets_.begin (), idleWidgets_.end ());
+		for (Widget* w : idleWidgets)
+		{
+			if (idleWidgets_.find (w) != idleWidgets_.end ()) w->onIdle ();
+		}
+	}
+
+	// Post all expose requests of this cycle as one redisplay
+	if (exposeDamage_ != BUtilities::RectArea ())
+	{
+		puglPostRedisplayRect (view_, {exposeDamage_.getX(), exposeDamage_.getY(), exposeDamage_.getWidth(), exposeDamage_.getHeight()});
+		exposeDamage_ = BUtilities::RectArea ();
+	}
 }
 
 PuglStatus Window::translatePuglEvent (PuglView* view, const PuglEvent* puglEvent)
@@ -767,6 +804,7 @@ void Window::purgeEventQueue (Widget* widget)
 		)
 		{
 			it = eventQueue_.erase (it);
+			releasePendingEvent (event);
 			delete event;
 		}
 		else ++it;
@@ -24,6 +24,8 @@
 #include <chrono>
 #include <deque>
 #include <list>
+#include <map>
+#include <set>
 #include "Widget.hpp"
 
 namespace BWidgets
@@ -127,6 +129,23 @@ public:
 	 */
 	void purgeEventQueue (Widget* widget = nullptr);
 
+	/*
+	 * Adds an area (absolute coordinates) to be redisplayed. All areas added
+	 * within one handleEvents () cycle are merged and posted to pugl as a
+	 * single redisplay at the end of the cycle.
+	 * @param area	Area to be redisplayed
+	 */
+	void addExposeDamage (const BUtilities::RectArea& area);
+
+	/*
+	 * Adds or removes a widget to / from the list of widgets whose
+	 * onIdle () is called once per handleEvents () cycle. Use
+	 * Widget::setIdle () instead of calling these methods directly.
+	 * @param widget	Widget
+	 */
+	void addIdleWidget (Widget* widget);
+	void removeIdleWidget (Widget* widget);
+
 protected:
 
 	/**
@@ -139,6 +158,7 @@ protected:
 	void mergeEvents ();
 
 	void unfocus();
+	void releasePendingEvent (BEvents::Event* event);
 
 	std::string title_;
 	PuglWorld* world_;
@@ -149,6 +169,9 @@ protected:
 	BUtilities::Point pointer_;
 
 	std::deque<BEvents::Event*> eventQueue_;		// TODO: std::list ?
+	std::map<std::pair<Widget*, BEvents::EventType>, BEvents::Event*> pendingEvents_;
+	BUtilities::RectArea exposeDamage_;
+	std::set<Widget*> idleWidgets_;
 };
 
 }
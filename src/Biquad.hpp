@@ -25,6 +25,7 @@
 
 #include <cmath>
 #include "Stereo.hpp"
+#include "BiquadCascade.hpp"
 
 class Biquad
 {
@@ -68,6 +69,8 @@ public:
 		build();
 	}
 
+	BiquadCoefficients getCoefficients () const {return BiquadCoefficients {a0, a1, a2, b1, b2};}
+
 	Stereo process (const Stereo& in) 
 	{
 		Stereo out = in * a0 + z1;
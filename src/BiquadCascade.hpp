@@ -0,0 +1,143 @@
+/* B.Oops
+ * Glitch effect sequencer LV2 plugin
+ *
+ * Copyright (C) 2020 by Sven Jähnichen
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef BIQUADCASCADE_HPP_
+#define BIQUADCASCADE_HPP_
+
+#include <array>
+#include "Stereo.hpp"
+
+#define BIQUADCASCADE_MAXSECTIONS 16
+
+/*
+ * Coefficients of a second order section, normalized to b0 = 1 and named
+ * as in Biquad: out = a0 * in + a1 * in[-1] + a2 * in[-2]
+ * - b1 * out[-1] - b2 * out[-2].
+ */
+struct BiquadCoefficients
+{
+	float a0, a1, a2;
+	float b1, b2;
+};
+
+/*
+ * Serial chain of up to BIQUADCASCADE_MAXSECTIONS second order sections in
+ * transposed direct form II. Left and right are processed together. The
+ * coefficients can either be set at once or linear ramped to new values
+ * over a number of frames.
+ */
+class BiquadCascade
+{
+public:
+	BiquadCascade () : size (0), rampFrames (0)
+	{
+		a0.fill (1.0f);
+		a1.fill (0.0f);
+		a2.fill (0.0f);
+		b1.fill (0.0f);
+		b2.fill (0.0f);
+		clear ();
+	}
+
+	int getSize () const {return size;}
+
+	/*
+	 * Sets the coefficients of the first n sections and stops ramping.
+	 */
+	void set (const BiquadCoefficients* coeffs, const int n)
+	{
+		size = (n < BIQUADCASCADE_MAXSECTIONS ? (n > 0 ? n : 0) : BIQUADCASCADE_MAXSECTIONS);
+		for (int i = 0; i < size; ++i)
+		{
+			a0[i] = coeffs[i].a0;
+			a1[i] = coeffs[i].a1;
+			a2[i] = coeffs[i].a2;
+			b1[i] = coeffs[i].b1;
+			b2[i] = coeffs[i].b2;
+		}
+		rampFrames = 0;
+	}
+
+	/*
+	 * Ramps the coefficients of the first n sections to coeffs within the
+	 * next frames calls of process(). Falls back to set() if the number of
+	 * sections changes.
+	 */
+	void ramp (const BiquadCoefficients* coeffs, const int n, const int frames)
+	{
+		if ((n != size) || (frames <= 1))
+		{
+			set (coeffs, n);
+			return;
+		}
+
+		const float f = 1.0f / float (frames);
+		for (int i = 0; i < size; ++i)
+		{
+			da0[i] = (coeffs[i].a0 - a0[i]) * f;
+			da1[i] = (coeffs[i].a1 - a1[i]) * f;
+			da2[i] = (coeffs[i].a2 - a2[i]) * f;
+			db1[i] = (coeffs[i].b1 - b1[i]) * f;
+			db2[i] = (coeffs[i].b2 - b2[i]) * f;
+		}
+		rampFrames = frames;
+	}
+
+	Stereo process (const Stereo& input)
+	{
+		if (rampFrames > 0)
+		{
+			for (int i = 0; i < size; ++i)
+			{
+				a0[i] += da0[i];
+				a1[i] += da1[i];
+				a2[i] += da2[i];
+				b1[i] += db1[i];
+				b2[i] += db2[i];
+			}
+			--rampFrames;
+		}
+
+		Stereo s = input;
+		for (int i = 0; i < size; ++i)
+		{
+			const Stereo out = s * a0[i] + z1[i];
+			z1[i] = s * a1[i] + z2[i] - out * b1[i];
+			z2[i] = s * a2[i] - out * b2[i];
+			s = out;
+		}
+		return s;
+	}
+
+	void clear ()
+	{
+		z1.fill (Stereo());
+		z2.fill (Stereo());
+	}
+
+protected:
+	int size;
+	int rampFrames;
+	std::array<float, BIQUADCASCADE_MAXSECTIONS> a0, a1, a2, b1, b2;
+	std::array<float, BIQUADCASCADE_MAXSECTIONS> da0, da1, da2, db1, db2;
+	std::array<Stereo, BIQUADCASCADE_MAXSECTIONS> z1, z2;
+};
+
+#endif /* BIQUADCASCADE_HPP_ */
@@ -24,36 +24,47 @@
 #include "ButterworthLowPassFilter.hpp"
 #include "ButterworthHighPassFilter.hpp"
 
+/*
+ * Low pass and high pass sections in a single cascade.
+ */
 class ButterworthBandPassFilter
 {
 public:
-	ButterworthBandPassFilter (const double rate, const double lowCutoff, const double highCutoff, const int order) :
-		lowpass (rate, highCutoff, order),
-		highpass (rate, lowCutoff, order)
+	ButterworthBandPassFilter (const double rate, const double lowCutoff, const double highCutoff, const int order)
 	{
-
+		set (rate, lowCutoff, highCutoff, order);
 	}
 
-	void set (const double rate, const double lowCutoff, const double highCutoff, const int order)
+	/*
+	 * Sets the filter. Ramps to the new coefficients within the next frames
+	 * push() calls if frames > 0 and the order is unchanged.
+	 */
+	void set (const double rate, const double lowCutoff, const double highCutoff, const int order, const int frames = 0)
 	{
-		lowpass.set (rate, highCutoff, order);
-		highpass.set (rate, lowCutoff, order);
+		const int nl = ButterworthLowPassFilter::design (rate, highCutoff, order, coeffs.data());
+		const int nh = ButterworthHighPassFilter::design (rate, lowCutoff, order, coeffs.data() + nl);
+		if (frames > 0) cascade.ramp (coeffs.data(), nl + nh, frames);
+		else cascade.set (coeffs.data(), nl + nh);
 	}
 
-	Stereo push (const Stereo& input) {return highpass.push (lowpass.push (input));}
+	Stereo push (const Stereo& input)
+	{
+		output = cascade.process (input);
+		return output;
+	}
 
-	Stereo get () const {return highpass.get();}
+	Stereo get () const {return output;}
 
 	void clear()
 	{
-		lowpass.clear();
-		highpass.clear();
+		cascade.clear();
+		output = Stereo();
 	}
 
-
 protected:
-	ButterworthLowPassFilter lowpass;
-	ButterworthHighPassFilter highpass;
+	std::array <BiquadCoefficients, BUTTERWORTH_MAXORDER> coeffs;
+	BiquadCascade cascade;
+	Stereo output;
 };
 
 #endif /* BUTTERWORTHBANDPASSFILTER_HPP_ */
@@ -24,6 +24,7 @@
 #include <cmath>
 #include <array>
 #include "Stereo.hpp"
+#include "BiquadCascade.hpp"
 
 #define BUTTERWORTH_MAXORDER 16
 
@@ -34,27 +35,15 @@ public:
 
 	ButterworthFilter (const int order) :
 		order (order),
-		o2 (order / 2),
-		f1 (1)
+		o2 (order / 2)
 	{
-		coeff0.fill (0);
-		coeff1.fill (0);
-		coeff2.fill (0);
+		coeffs.fill (BiquadCoefficients {1.0f, 0.0f, 0.0f, 0.0f, 0.0f});
 		clear();
 	}
 
 	Stereo push (const Stereo& input)
 	{
-		output = input;
-
-		for (int i = 0; i < o2; ++i)
-		{
-			buffer0[i] = buffer1[i] * coeff1[i] + buffer2[i] * coeff2[i] + output;
-			output = (buffer0[i] + buffer1[i] * f1 + buffer2[i]) * coeff0[i];
-			buffer2[i] = buffer1[i];
-			buffer1[i] = buffer0[i];
-		}
-
+		output = cascade.process (input);
 		return output;
 	}
 
@@ -62,23 +51,23 @@ public:
 
 	void clear()
 	{
-		buffer0.fill (Stereo());
-		buffer1.fill (Stereo());
-		buffer2.fill (Stereo());
+		cascade.clear();
+		output = Stereo();
 	}
 
-
 protected:
 	int order;
 	int o2;
-	std::array <float, BUTTERWORTH_MAXORDER / 2> coeff0;
-	std::array <float, BUTTERWORTH_MAXORDER / 2> coeff1;
-	std::array <float, BUTTERWORTH_MAXORDER / 2> coeff2;
-	float f1;
-	std::array <Stereo, BUTTERWORTH_MAXORDER / 2> buffer0;
-	std::array <Stereo, BUTTERWORTH_MAXORDER / 2> buffer1;
-	std::array <Stereo, BUTTERWORTH_MAXORDER / 2> buffer2;
+	std::array <BiquadCoefficients, BUTTERWORTH_MAXORDER / 2> coeffs;
+	BiquadCascade cascade;
 	Stereo output;
+
+	// Applies coeffs either at once (frames = 0) or ramped
+	void apply (const int frames)
+	{
+		if (frames > 0) cascade.ramp (coeffs.data(), o2, frames);
+		else cascade.set (coeffs.data(), o2);
+	}
 };
 
 #endif /* BUTTERWORTHFILTER_HPP_ */
@@ -32,13 +32,24 @@ public:
 		set (rate, cutoff, order);
 	}
 
-	void set (const double rate, const double cutoff, const int order)
+	/*
+	 * Sets the filter. Ramps to the new coefficients within the next frames
+	 * push() calls if frames > 0 and the order is unchanged.
+	 */
+	void set (const double rate, const double cutoff, const int order, const int frames = 0)
 	{
-
 		this->order = order;
-		o2 = order / 2;
-		f1 = 2;
+		o2 = design (rate, cutoff, order, coeffs.data());
+		apply (frames);
+	}
 
+	/*
+	 * Calculates the order / 2 second order sections. Returns the number of
+	 * sections.
+	 */
+	static int design (const double rate, const double cutoff, const int order, BiquadCoefficients* dest)
+	{
+		const int o2 = order / 2;
 		const double a = tan (M_PI * cutoff / rate);
 		const double a2 = a * a;
 
@@ -46,12 +57,15 @@ public:
 		{
 			const double r = sin (M_PI * (2.0 * double (i) + 1.0) / (2.0 * double (order)));
 			const double s = a2 + 2.0 * a * r + 1.0;
-			coeff0[i] = a2 / s;
-			coeff1[i] = 2.0 * (1.0 - a2) / s;
-			coeff2[i] = -(a2 - 2.0 * a * r + 1.0) / s;
+			const double c0 = a2 / s;
+			dest[i].a0 = c0;
+			dest[i].a1 = 2.0 * c0;
+			dest[i].a2 = c0;
+			dest[i].b1 = -2.0 * (1.0 - a2) / s;
+			dest[i].b2 = (a2 - 2.0 * a * r + 1.0) / s;
 		}
+		return o2;
 	}
-
 };
 
 #endif /* BUTTERWORTHLOWPASSFILTER_HPP_ */
@@ -276,7 +276,9 @@ const Limit controllerLimits[NR_CONTROLLERS] =
 	{0.0, 1.0, 0.0},
 	{0.0, 1.0, 0.0},
 	{0.0, 1.0, 0.0},
-	{0.0, 1.0, 0.0}
+	{0.0, 1.0, 0.0},
+	{0, 1, 1},		// INTERPOLATION
+	{0, 1, 1}		// FORCE_MONO
 };
 
 
@@ -22,30 +22,49 @@
 #define CRACKLE_HPP_
 
 #include <cmath>
+#include <vector>
 
 #ifndef SQR
 #define SQR(x) ((x) * (x))
 #endif
 
+#define CRACKLE_END 58.23f		// Amplitude < -70 dB
+#define CRACKLE_RESOLUTION 64		// Table points per crackle period
+
+/*
+ * Wavetable of a single crackle sin (2 pi sqrt (u)) / (1 + (u - 2)^2) with
+ * u = (t - t0) * freq. Shared by all crackles. A crackle only needs to
+ * advance u by freq / samplerate per frame.
+ */
 class Crackle
 {
 public:
-	Crackle () : Crackle (0, 0, 0) {}
-
-	Crackle (const double t0, const double level, const double freq) :
-		t0_ (t0),
-		level_ (level),
-		freq_ (freq)
-	{}
-
-	double get (const double t) const {return level_ * sin (2.0 * M_PI * sqrt ((t - t0_) * freq_)) / (1.0 + SQR ((t - t0_) * freq_ - 2.0));}
+	static const std::vector<float>& getTable ()
+	{
+		static const std::vector<float> table = makeTable ();
+		return table;
+	}
 
-	double getAmplitude (const double t) const {return 1.0 / (1.0 + SQR ((t - t0_) * freq_ - 2.0));}
+	static float get (const float* table, const float u)
+	{
+		const float x = u * CRACKLE_RESOLUTION;
+		const int i = x;
+		const float f = x - i;
+		return table[i] + f * (table[i + 1] - table[i]);
+	}
 
 protected:
-	double t0_;
-	double level_;
-	double freq_;
+	static std::vector<float> makeTable ()
+	{
+		const int n = ceil (CRACKLE_END * CRACKLE_RESOLUTION) + 2;
+		std::vector<float> table (n, 0.0f);
+		for (int i = 0; i < n; ++i)
+		{
+			const double u = double (i) / CRACKLE_RESOLUTION;
+			table[i] = sin (2.0 * M_PI * sqrt (u)) / (1.0 + SQR (u - 2.0));
+		}
+		return table;
+	}
 };
 
 #endif /* CRACKLE_HPP_ */
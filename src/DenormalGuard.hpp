@@ -0,0 +1,78 @@
+/* B.Oops
+ * Glitch effect sequencer LV2 plugin
+ *
+ * Copyright (C) 2020 by Sven Jähnichen
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DENORMALGUARD_HPP_
+#define DENORMALGUARD_HPP_
+
+#include <cstdint>
+
+#if defined (__SSE__) || defined (__x86_64__) || defined (_M_X64)
+#include <xmmintrin.h>
+#define DENORMALGUARD_SSE
+#define DENORMALGUARD_MXCSR_FTZ 0x8000
+#define DENORMALGUARD_MXCSR_DAZ 0x0040
+#elif defined (__aarch64__)
+#define DENORMALGUARD_AARCH64
+#define DENORMALGUARD_FPCR_FZ (uint64_t (1) << 24)
+#endif
+
+/*
+ * Scoped flush-to-zero / denormals-are-zero mode. Sets the FTZ and DAZ
+ * bits of the MXCSR (x86 SSE) or the FZ bit of the FPCR (AArch64) and
+ * restores the previous state at the end of the scope. Does nothing if
+ * not enabled or on other platforms.
+ */
+class DenormalGuard
+{
+public:
+	DenormalGuard (const bool enable = true) : enabled (enable), state (0)
+	{
+		if (!enabled) return;
+#if defined (DENORMALGUARD_SSE)
+		state = _mm_getcsr ();
+		_mm_setcsr (state | DENORMALGUARD_MXCSR_FTZ | DENORMALGUARD_MXCSR_DAZ);
+#elif defined (DENORMALGUARD_AARCH64)
+		uint64_t fpcr;
+		__asm__ __volatile__ ("mrs %0, fpcr" : "=r" (fpcr));
+		state = fpcr;
+		__asm__ __volatile__ ("msr fpcr, %0" : : "r" (fpcr | DENORMALGUARD_FPCR_FZ));
+#endif
+	}
+
+	~DenormalGuard ()
+	{
+		if (!enabled) return;
+#if defined (DENORMALGUARD_SSE)
+		_mm_setcsr (state);
+#elif defined (DENORMALGUARD_AARCH64)
+		const uint64_t fpcr = state;
+		__asm__ __volatile__ ("msr fpcr, %0" : : "r" (fpcr));
+#endif
+	}
+
+	DenormalGuard (const DenormalGuard& that) = delete;
+	DenormalGuard& operator= (const DenormalGuard& that) = delete;
+
+protected:
+	bool enabled;
+	uint64_t state;
+};
+
+#endif /* DENORMALGUARD_HPP_ */
@@ -25,15 +25,19 @@
 #define LIMIT(g , min, max) ((g) > (max) ? (max) : ((g) < (min) ? (min) : (g)))
 #endif /* LIMIT */
 
-#include <random>
 #include <ctime>
 #include <stdexcept>
 #include "Stereo.hpp"
 #include "RingBuffer.hpp"
+#include "Resampler.hpp"
 #include "Pad.hpp"
 #include "Definitions.hpp"
 #include "Ports.hpp"
 #include "Shape.hpp"
+#include "Random.hpp"
+
+#define FX_TAIL_INFINITE -1
+#define FX_TAIL_DECAY -2
 
 class Fx
 {
@@ -42,7 +46,7 @@ public:
 
 	Fx (RingBuffer<Stereo>** buffer, float* params, Pad* pads) :
 		buffer (buffer), params (params), pads (pads),
-		shapePaused (true), playing (false), panf (), unpanf(),
+		shapePaused (true), playing (false), mono (0), quality (RESAMPLER_DEFAULT_QUALITY), wet (), panf (), unpanf(),
 		rnd (time (0)), unidist (0.0, 1.0), bidist (-1.0, 1.0)
 	{
 		if (!buffer) throw std::invalid_argument ("Fx initialized with buffer nullptr");
@@ -72,29 +76,90 @@ public:
 
 	virtual Stereo playPad (const double position, const double size, const double mixf)
 	{
-		return mix ((**buffer).front(), process (position, size), position, size, mixf);
+		wet = process (position, size);
+		return mix ((**buffer).front(), wet, position, size, mixf);
 	}
 
 	virtual Stereo play (const double position, const double size, const double mx, const double mixf)
 	{
-		return BUtilities::mix<Stereo> ((**buffer).front(), pan ((**buffer).front(), process (position, size)), params[SLOTS_MIX] * mx * mixf);
+		wet = process (position, size);
+		return BUtilities::mix<Stereo> ((**buffer).front(), pan ((**buffer).front(), wet), params[SLOTS_MIX] * mx * mixf);
 	}
 
 	virtual void end () {playing = false;}
 
+	/*
+	 * Replaces the default (time based) seed of the random generators.
+	 * Called before the first init () and again on running effects if a
+	 * state with a seed is restored.
+	 */
+	virtual void seed (const uint32_t value) {rnd.seed (value);}
+
 	virtual bool isPlaying () {return playing;}
 
+	/*
+	 * Sets the number of the latest frames in the buffer with identical
+	 * channels. Effects may process a single channel then.
+	 */
+	void setMono (const long frames) {mono = frames;}
+
+	/*
+	 * Sets the interpolation quality (RESAMPLER_HERMITE or RESAMPLER_SINC)
+	 * for fractional reads from the buffer.
+	 */
+	void setQuality (const int value) {quality = value;}
+
+	/*
+	 * Buffer-reading effects with positions independent from the audio
+	 * signal and without writing back to the buffer may calculate the
+	 * buffer frames (0 = front) for n positions at once and return true.
+	 * The result is the same as for n subsequent process () calls.
+	 */
+	virtual bool getFrames (const double* positions, const int n, double* frames) {return false;}
+
+	/*
+	 * Block version of playPad () for the frames calculated by getFrames ().
+	 * All input frames must already be pushed to the buffer. Frames refer
+	 * to the buffer front after all pushes.
+	 */
+	void playPadFrames (const double* positions, const double* frames, const int n, const double size, const double mixf, const Stereo* input, Stereo* output)
+	{
+		Resampler::get (**buffer, frames, output, n, quality);
+		for (int i = 0; i < n; ++i)
+		{
+			wet = output[i];
+			output[i] = mix (input[i], wet, positions[i], size, mixf);
+		}
+	}
+
+	/*
+	 * Number of frames the output may still be non-silent after the input
+	 * became silent. FX_TAIL_DECAY for decaying tails of unknown length.
+	 * FX_TAIL_INFINITE (default) for effects which generate signals on their
+	 * own or need to be processed for each frame.
+	 */
+	virtual long getTail () const {return FX_TAIL_INFINITE;}
+
+	/*
+	 * Effect output of the latest play () or playPad () call before pan,
+	 * ADSR and mix.
+	 */
+	Stereo getWet () const {return wet;}
+
 protected:
 	RingBuffer<Stereo>** buffer;
 	float* params;
 	Pad* pads;
 	bool shapePaused;
 	bool playing;
+	long mono;
+	int quality;
+	Stereo wet;
 	Stereo panf;
 	Stereo unpanf;
-	std::minstd_rand rnd;
-	std::uniform_real_distribution<float> unidist;
-	std::uniform_real_distribution<float> bidist;
+	FastRandom rnd;
+	FastUniform unidist;
+	FastUniform bidist;
 
 	float adsr (const double position, const double size) const
 	{
@@ -119,19 +184,10 @@ protected:
 		return params[SLOTS_SUSTAIN];
 	}
 
-	Stereo getSample (const double frame)
+	Stereo getSample (const double frame) const
 	{
-		const float x = fmodf (frame, 1.0);
-		if (x == 0.0f) return (**buffer)[frame];
-		if (frame < 1.0) return BUtilities::mix<Stereo> ((**buffer)[frame], (**buffer)[frame + 1], x);
-		
-		// 4-point, 3rd-order Hermite (x-form)
-		const int f = frame;
-		Stereo c0 = (**buffer)[f];
-		Stereo c1 = ((**buffer)[f + 1] - (**buffer)[f - 1]) * 0.5;
-		Stereo c2 = (**buffer)[f - 1] - (**buffer)[f] * 2.5 + (**buffer)[f + 1] * 2.0 - (**buffer)[f + 2] * 0.5;
-		Stereo c3 = ((**buffer)[f + 2] - (**buffer)[f - 1]) * 0.5 + ((**buffer)[f] - (**buffer)[f + 1]) * 1.5;
-		return ((c3 * x + c2) * x + c1) * x + c0;
+		if (frame + RESAMPLER_SINC_TAPS < mono) return Resampler::getMono (**buffer, frame, quality);
+		return Resampler::get (**buffer, frame, quality);
 	}
 
 	Stereo pan (const Stereo s0, const Stereo s1) const {return panf * s1 + unpanf * s0;}
@@ -48,6 +48,8 @@ public:
 		return (**buffer).front() * amp;
 	}
 
+	virtual long getTail () const override {return 0;}
+
 protected:
 	float amp;
 
@@ -55,6 +55,8 @@ public:
 		};
 	}
 
+	virtual long getTail () const override {return 0;}
+
 protected:
 	float balance;
 
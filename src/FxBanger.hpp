@@ -29,14 +29,20 @@
 #define FX_BANGER_SPIN 10
 #define FX_BANGER_SPINRAND 11
 
+#define FX_BANGER_CONTROLFRAMES 32
+
 class FxBanger : public Fx
 {
 public:
 	FxBanger () = delete;
 
-	FxBanger (RingBuffer<Stereo>** buffer, float* params, Pad* pads, double rate) :
+	FxBanger (RingBuffer<Stereo>** buffer, float* params, Pad* pads, double rate, int controlFrames = FX_BANGER_CONTROLFRAMES) :
 		Fx (buffer, params, pads),
 		rate (rate),
+		controlFrames (controlFrames > 1 ? controlFrames : 1),
+		controlCount (0),
+		ramp (false),
+		smooth (1.0 - pow (1.0 - 1.0 / rate, controlFrames > 1 ? controlFrames : 1)),
 		count (0.0),
 		xregion (rate),
 		xparams {{0.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 0.0f}},
@@ -50,6 +56,12 @@ public:
 
 	{}
 
+	virtual void seed (const uint32_t value) override
+	{
+		Fx::seed (value);
+		xregion.seed (value);
+	}
+
 	virtual void init (const double position) override
 	{
 		Fx::init (position);
@@ -62,9 +74,64 @@ public:
 				xparams[i][j] = LIMIT (params[SLOTS_OPTPARAMS + 2 * j] + r * params[SLOTS_OPTPARAMS + 2 * j + 1], 0.0, 1.0);
 			}
 		}
+
+		// Apply new params immediately
+		controlCount = 0;
+		ramp = false;
 	}
 
 	virtual Stereo process (const double position, const double size) override
+	{
+		// Cursor and XRegion coefficients run at the control rate. The
+		// coefficients are ramped within each control period.
+		if (controlCount <= 0)
+		{
+			updateCursor ();
+
+			float xp[6] = {0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+			for (int i = 0; i < 4; ++i)
+			{
+				xp[i] =
+				(
+					((1.0f - xcursor) * (1.0f - ycursor) * xparams[0][i]) +
+					((1.0f - xcursor) * ycursor * xparams[1][i]) +
+					(xcursor * ycursor * xparams[2][i]) +
+					(xcursor * (1.0 - ycursor) * xparams[3][i])
+				);
+			}
+
+			if (ramp) xregion.setParameters (xp, controlFrames);
+			else xregion.setParameters (xp);
+			ramp = true;
+			controlCount = controlFrames;
+		}
+
+		--controlCount;
+		Stereo s0 = (**buffer).front();
+		Stereo s1 = Stereo();
+		xregion.process (&s0.left, &s0.right, &s1.left, &s1.right, 1);
+		return s1;
+	}
+
+protected:
+	double rate;
+	int controlFrames;
+	int controlCount;
+	bool ramp;
+	double smooth;
+	double count;
+	XRegion xregion;
+	float xparams[4][4];
+	float speed;
+	float spin;
+	float ang;
+	float nspeed;
+	float nspin;
+	float xcursor;
+	float ycursor;
+
+	// Moves the cursor by one control period
+	void updateCursor ()
 	{
 		if (count >= rate)
 		{
@@ -73,20 +140,20 @@ public:
 			count = 0.0;
 		}
 
-		else count++;
+		else count += controlFrames;
 
 		// Update speed
-		speed = (1.0 - 1.0 / rate) * speed + (1.0 / rate) * nspeed;
+		speed += smooth * (nspeed - speed);
 
 		// Update ang
-		spin = (1.0 - 1.0 / rate) * spin + (1.0 / rate) * nspin;
-		ang += 2.0 * M_PI * (10.0 / rate) * spin;
+		spin += smooth * (nspin - spin);
+		ang += 2.0 * M_PI * (10.0 / rate) * spin * controlFrames;
 
 		// Calulate new positions
 		const float dx = sinf (ang);
 		const float dy = cosf (ang);
-		xcursor += dx * (1.0 / rate) * 4.0 * speed * speed;
-		ycursor += dy * (1.0 / rate) * 4.0 * speed * speed;
+		xcursor += dx * (controlFrames / rate) * 4.0 * speed * speed;
+		ycursor += dy * (controlFrames / rate) * 4.0 * speed * speed;
 
 		// Reflections
 		if (xcursor < 0.0f)
@@ -112,39 +179,7 @@ public:
 			ycursor = 1.0f;
 			if (dy > 0.0f) {ang = -M_PI - ang; spin = 0.0f;}
 		}
-
-		// Calculate params for cursor position
-		float xp[6] = {0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f};
-		for (int i = 0; i < 4; ++i)
-		{
-			xp[i] =
-			(
-				((1.0f - xcursor) * (1.0f - ycursor) * xparams[0][i]) +
-				((1.0f - xcursor) * ycursor * xparams[1][i]) +
-				(xcursor * ycursor * xparams[2][i]) +
-				(xcursor * (1.0 - ycursor) * xparams[3][i])
-			);
-		}
-
-		xregion.setParameters (xp);
-		Stereo s0 = (**buffer).front();
-		Stereo s1 = Stereo();
-		xregion.process (&s0.left, &s0.right, &s1.left, &s1.right, 1);
-		return s1;
 	}
-
-protected:
-	double rate;
-	double count;
-	XRegion xregion;
-	float xparams[4][4];
-	float speed;
-	float spin;
-	float ang;
-	float nspeed;
-	float nspin;
-	float xcursor;
-	float ycursor;
 };
 
 #endif /* FXBANGER_HPP_ */
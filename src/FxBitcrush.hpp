@@ -50,20 +50,21 @@ public:
 	virtual Stereo process (const double position, const double size) override
 	{
 		const Stereo s0 = (**buffer).front();
-		const float l1 = LIMIT (s0.left + limit, 0, 2.0 * limit) / (2.0 * limit);
-		const float l2 = round (l1 * f);
-		const float l3 = (l2 - 0.5 * f) * 2.0 * limit / f;
-		const float r1 = LIMIT (s0.right + limit, 0, 2.0 * limit) / (2.0 * limit);
-		const float r2 = round (r1 * f);
-		const float r3 = (r2 - 0.5 * f) * 2.0 * limit / f;
-
-		return Stereo (l3, r3);
+		const float l = crush (s0.left);
+		return Stereo (l, (mono > 0 ? l : crush (s0.right)));
 	}
 
 protected:
 	float limit;
 	int bit;
 	float f;
+
+	float crush (const float input) const
+	{
+		const float x1 = LIMIT (input + limit, 0, 2.0 * limit) / (2.0 * limit);
+		const float x2 = round (x1 * f);
+		return (x2 - 0.5 * f) * 2.0 * limit / f;
+	}
 };
 
 #endif /* FXBITCRUSH_HPP_ */
@@ -77,6 +77,8 @@ public:
 		return s1;
 	}
 
+	virtual long getTail () const override {return 0;}
+
 protected:
 	int nr;
 	float smoothing;
@@ -23,7 +23,6 @@
 
 #include "Fx.hpp"
 #include "Crackle.hpp"
-#include "StaticArrayList.hpp"
 
 #ifndef DB2CO
 #define DB2CO(x) pow (10, 0.05 * (x))
@@ -52,7 +51,13 @@ public:
 		framesPerStepPtr (framesPerStep),
 		framesPerStep (24000),
 		rate (0.0f),
-		c (0)
+		maxsize (0.0f),
+		distrib (0.0f),
+		table (Crackle::getTable().data()),
+		nrCrackles (0),
+		crackleU {0.0f},
+		crackleInc {0.0f},
+		crackleLevel {0.0f}
 	{
 		if (!framesPerStep) throw std::invalid_argument ("Fx initialized with framesPerStep nullptr");
 	}
@@ -70,15 +75,11 @@ public:
 		maxsize = amp * LIMIT (params[SLOTS_OPTPARAMS + FX_CRACKLES_MAXSIZE] + r3 * params[SLOTS_OPTPARAMS + FX_CRACKLES_MAXSIZERAND], 0.0, 1.0);
 		const double r4 = bidist (rnd);
 		distrib = 10.0 * LIMIT (params[SLOTS_OPTPARAMS + FX_CRACKLES_DISTRIBUTION] + r4 * params[SLOTS_OPTPARAMS + FX_CRACKLES_DISTRIBUTIONRAND], 0.0, 1.0);
-		c = 0;
-		crackles.clear();
+		nrCrackles = 0;
 	}
 
 	virtual Stereo process (const double position, const double size) override
 	{
-		double t = double (c) / samplerate;
-		++c;
-
 		const Stereo s0 = (**buffer).front();
 
 		// Randomly generate new crackles
@@ -87,24 +88,30 @@ public:
 		{
 			const double r1 = unidist (rnd);
 			const double r2 = bidist (rnd);
-			const double level = maxsize * pow (r1, distrib);
-			const double freq = CRACKLEFREQ + r2 * CRACKLEFREQRAND;
-			crackles.push_back (Crackle (t, level, freq));
+			const int i = (nrCrackles < MAXCRACKLES ? nrCrackles++ : MAXCRACKLES - 1);
+			crackleU[i] = 0.0f;
+			crackleInc[i] = (CRACKLEFREQ + r2 * CRACKLEFREQRAND) / samplerate;
+			crackleLevel[i] = maxsize * pow (r1, distrib);
 		}
 
-		// Iterate through crackles
-		Stereo s1 = s0;
-		for (Crackle** iit = crackles.begin(); iit < crackles.end ();)
+		// Play all live crackles, remove the faded out ones
+		float cr = 0.0f;
+		for (int i = 0; i < nrCrackles; )
 		{
-			double cr = (**iit).get (t);
-			s1 +=  Stereo (cr, cr);
-
-			// Delete if < -70 db
-			if ((**iit).getAmplitude (t) < 0.000316228) iit = crackles.erase (iit);
-			else ++iit;
+			cr += crackleLevel[i] * Crackle::get (table, crackleU[i]);
+			crackleU[i] += crackleInc[i];
+
+			if (crackleU[i] >= CRACKLE_END)
+			{
+				--nrCrackles;
+				crackleU[i] = crackleU[nrCrackles];
+				crackleInc[i] = crackleInc[nrCrackles];
+				crackleLevel[i] = crackleLevel[nrCrackles];
+			}
+			else ++i;
 		}
 
-		return s1;
+		return s0 + Stereo (cr, cr);
 	}
 
 protected:
@@ -114,9 +121,11 @@ protected:
 	float rate;
 	float maxsize;
 	float distrib;
-	StaticArrayList<Crackle, MAXCRACKLES> crackles;
-	long c;
-
+	const float* table;
+	int nrCrackles;
+	float crackleU[MAXCRACKLES];
+	float crackleInc[MAXCRACKLES];
+	float crackleLevel[MAXCRACKLES];
 };
 
 #endif /* FXCRACKLES_HPP_ */
@@ -67,6 +67,7 @@ public:
 	{
 		const Stereo s0 = (**buffer).front();
 		Stereo s1 = process (position, size);
+		wet = s1;
 		s1 = mix (s0, s1, position, size, mixf);
 		Stereo s2 = s1;
 		(**buffer).front() = s2.mix (s0, 1.0f - feedback);
@@ -77,12 +78,16 @@ public:
 	{
 		const Stereo s0 = (**buffer).front();
 		Stereo s1 = process (position, size);
+		wet = s1;
 		s1 = BUtilities::mix<Stereo> (s0, pan (s0, s1), params[SLOTS_MIX] * mx * mixf);
 		Stereo s2 = s1;
 		(**buffer).front() = s2.mix (s0, 1.0f - feedback);
 		return s1;
 	}
 
+	// Feedback is written back to the buffer
+	virtual long getTail () const override {return (feedback > 0.0f ? FX_TAIL_INFINITE : std::min (long (*framesPerStepPtr * range * delay) + 3, long ((**buffer).size())));}
+
 protected:
 	double* framesPerStepPtr;
 	double framesPerStep;
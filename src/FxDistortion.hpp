@@ -63,65 +63,44 @@ public:
 	virtual Stereo process (const double position, const double size) override
 	{
 		const Stereo s0 = (**buffer).front();
-		double l = s0.left * drive / level;
-		double r = s0.right * drive / level;
-		switch (method)
-		{
-			case HARDCLIP:
-				l = LIMIT (l * level, -level, level);
-				r = LIMIT (r * level, -level, level);
-				break;
-
-			case SOFTCLIP:
-				l = SGN (l) * level * sqrt (SQR (l) / (1.0 + SQR (l)));
-				r = SGN (r) * level * sqrt (SQR (r) / (1.0 + SQR (r)));
-				break;
-
-			case FOLDBACK:
-				l = fabs (l) <= 1.0 ? level * l : (SGN (l) * level * float (2 * (int ((abs (l) + 1) / 2) % 2) - 1) * (1.0 - fmodf(fabs (l) + 1.0, 2.0)));
-				r = fabs (r) <= 1.0 ? level * r : (SGN (r) * level * float (2 * (int ((abs (r) + 1) / 2) % 2) - 1) * (1.0 - fmodf(fabs (r) + 1.0, 2.0)));
-				break;
-
-			case OVERDRIVE:
-				l =
-				(
-					fabs (l) < (1.0/3.0) ?
-					2.0 * level * l :
-					(
-						fabs (l) < (2.0/3.0) ?
-						SGN (l) * level * (3.0 - SQR (2.0 - 3.0 * fabs (l))) / 3.0 :
-						level * SGN (l)
-					)
-				);
-
-				r =
-				(
-					fabs (r) < (1.0/3.0) ?
-					2.0 * level * r :
-					(
-						fabs (r) < (2.0/3.0) ?
-						SGN (r) * level * (3.0 - SQR (2.0 - 3.0 * fabs (r))) / 3.0 :
-						level * SGN (r)
-					)
-				);
-				break;
-
-			case FUZZ:
-				l = SGN (l) * level * (1.0 - expf (- fabs (l)));
-				r = SGN (r) * level * (1.0 - expf (- fabs (r)));
-				break;
-
-			default:
-				break;
-		}
-
-		return Stereo (l, r);
+		const float l = distort (s0.left);
+		return Stereo (l, (mono > 0 ? l : distort (s0.right)));
 	}
 
+	virtual long getTail () const override {return 0;}
+
 protected:
 	BOopsDistortionIndex method;
 	double drive;
 	double level;
+
+	float distort (const float input) const
+	{
+		const double x = input * drive / level;
+		switch (method)
+		{
+			case HARDCLIP:	return LIMIT (x * level, -level, level);
+
+			case SOFTCLIP:	return SGN (x) * level * sqrt (SQR (x) / (1.0 + SQR (x)));
+
+			case FOLDBACK:	return fabs (x) <= 1.0 ? level * x : (SGN (x) * level * float (2 * (int ((abs (x) + 1) / 2) % 2) - 1) * (1.0 - fmodf(fabs (x) + 1.0, 2.0)));
+
+			case OVERDRIVE:	return
+							(
+								fabs (x) < (1.0/3.0) ?
+								2.0 * level * x :
+								(
+									fabs (x) < (2.0/3.0) ?
+									SGN (x) * level * (3.0 - SQR (2.0 - 3.0 * fabs (x))) / 3.0 :
+									level * SGN (x)
+								)
+							);
+
+			case FUZZ:		return SGN (x) * level * (1.0 - expf (- fabs (x)));
+
+			default:		return x;
+		}
+	}
 };
 
 #endif /* FXDISTORTION_HPP_ */
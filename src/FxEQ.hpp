@@ -23,6 +23,7 @@
 
 #include "Fx.hpp"
 #include "BiquadPeakFilter.hpp"
+#include "BiquadCascade.hpp"
 
 class FxEQ : public Fx
 {
@@ -42,6 +43,7 @@ public:
 		filters[3].set (1500.0f, 1.0, 0.0f);	// Clarity
 		filters[4].set (4000.0f, 1.0, 0.0f);	// Presence
 		filters[5].set (15000.0f, 1.0, 0.0f);	// Air
+		setCascade ();
 	}
 
 	virtual void init (const double position) override
@@ -53,19 +55,29 @@ public:
 			gains[i] = 72.0f * LIMIT (params[SLOTS_OPTPARAMS + 2 * i] + r * params[SLOTS_OPTPARAMS + 2 * i + 1], 0.0f, 1.0f) - 36.0f;
 			filters[i].setPeakGain (gains[i]);
 		}
+		setCascade ();
 	}
 
 	virtual Stereo process (const double position, const double size) override
 	{
-		Stereo s = (**buffer).front();
-		for (int i = 0; i < 6; ++i) s = filters[i].process (s);
-		return s;
+		return cascade.process ((**buffer).front());
 	}
 
+	virtual long getTail () const override {return FX_TAIL_DECAY;}
+
 protected:
 	double rate;
 	float gains[6];
 	BiquadPeakFilter filters[6];
+	BiquadCascade cascade;
+
+	// The filters are only used to design the sections of the cascade
+	void setCascade ()
+	{
+		BiquadCoefficients coeffs[6];
+		for (int i = 0; i < 6; ++i) coeffs[i] = filters[i].getCoefficients ();
+		cascade.set (coeffs, 6);
+	}
 };
 
 #endif /* FXEQ_HPP_ */
@@ -57,6 +57,8 @@ public:
 		return filter.push ((**buffer).front());
 	}
 
+	virtual long getTail () const override {return FX_TAIL_DECAY;}
+
 protected:
 	double rate;
 	ButterworthBandPassFilter filter;
@@ -82,6 +82,7 @@ public:
 	{
 		const Stereo s0 = (**buffer).front();
 		Stereo s1 = process (position, size);
+		wet = s1;
 		s1 = mix (s0, s1, position, size, mixf);
 		Stereo s2 = s1;
 		(**buffer).front() = s2.mix (s0, 1.0f - feedback);
@@ -92,6 +93,7 @@ public:
 	{
 		const Stereo s0 = (**buffer).front();
 		Stereo s1 = process (position, size);
+		wet = s1;
 		s1 = BUtilities::mix<Stereo> (s0, pan (s0, s1), params[SLOTS_MIX] * mx * mixf);
 		Stereo s2 = s1;
 		(**buffer).front() = s2.mix (s0, 1.0f - feedback);
@@ -54,6 +54,12 @@ public:
 		bigness (0.5f)
 	{}
 
+	virtual void seed (const uint32_t value) override
+	{
+		Fx::seed (value);
+		galactic.seed (value);
+	}
+
 	virtual void init (const double position) override
 	{
 		Fx::init (position);
@@ -84,6 +90,7 @@ public:
 	{
 		const Stereo s0 = (**buffer).front();
 		const Stereo s1 = process (position, size);
+		wet = s1;
 		return mix (s0, s1, position, size, mixf);
 	}
 
@@ -91,9 +98,12 @@ public:
 	{
 		const Stereo s0 = (**buffer).front();
 		const Stereo s1 = process (position, size);
+		wet = s1;
 		return BUtilities::mix<Stereo> (s0, pan (s0, s1), params[SLOTS_MIX] * mx * mixf);
 	}
 
+	virtual long getTail () const override {return FX_TAIL_DECAY;}
+
 protected:
 	Galactic galactic;
 	float replace;
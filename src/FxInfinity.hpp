@@ -57,6 +57,12 @@ public:
 		feedback (1.0f)
 	{}
 
+	virtual void seed (const uint32_t value) override
+	{
+		Fx::seed (value);
+		infinity.seed (value);
+	}
+
 	virtual void init (const double position) override
 	{
 		Fx::init (position);
@@ -90,6 +96,7 @@ public:
 	{
 		const Stereo s0 = (**buffer).front();
 		const Stereo s1 = process (position, size);
+		wet = s1;
 		return mix (s0, s1, position, size, mixf);
 	}
 
@@ -97,9 +104,12 @@ public:
 	{
 		const Stereo s0 = (**buffer).front();
 		const Stereo s1 = process (position, size);
+		wet = s1;
 		return BUtilities::mix<Stereo> (s0, pan (s0, s1), params[SLOTS_MIX] * mx * mixf);
 	}
 
+	virtual long getTail () const override {return FX_TAIL_DECAY;}
+
 protected:
 	Infinity2 infinity;
 	float filter;
@@ -29,6 +29,7 @@
 
 #define FX_NOISE_AMP 0
 #define FX_NOISE_AMPRAND 1
+#define FX_NOISE_BLOCKSIZE 64
 
 class FxNoise : public Fx
 {
@@ -37,7 +38,9 @@ public:
 
 	FxNoise (RingBuffer<Stereo>** buffer, float* params, Pad* pads) :
 		Fx (buffer, params, pads),
-		amp (0.0f)
+		amp (0.0f),
+		noise {0.0f},
+		noisePos (2 * FX_NOISE_BLOCKSIZE)
 	{}
 
 	virtual void init (const double position) override
@@ -46,15 +49,27 @@ public:
 		const double r = bidist (rnd);
 		const float db = -90.0 + 102.0 * LIMIT (params[SLOTS_OPTPARAMS + FX_NOISE_AMP] + r * params[SLOTS_OPTPARAMS + FX_NOISE_AMPRAND], 0.0, 1.0);
 		amp = DB2CO (db);
+		noisePos = 2 * FX_NOISE_BLOCKSIZE;
 	}
 
 	virtual Stereo process (const double position, const double size) override
 	{
-		return Stereo {unidist (rnd) * amp, unidist (rnd) * amp};
+		// Render noise blockwise
+		if (noisePos >= 2 * FX_NOISE_BLOCKSIZE)
+		{
+			rnd.fill (noise, 2 * FX_NOISE_BLOCKSIZE, 0.0f, amp);
+			noisePos = 0;
+		}
+
+		const Stereo s {noise[noisePos], noise[noisePos + 1]};
+		noisePos += 2;
+		return s;
 	}
 
 protected:
 	float amp;
+	float noise[2 * FX_NOISE_BLOCKSIZE];
+	int noisePos;
 
 };
 
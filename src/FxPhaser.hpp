@@ -37,12 +37,14 @@
 #define FX_PHASER_STEPS 10
 #define FX_PHASER_MAXSTEPS 10
 
+#define FX_PHASER_CONTROLFRAMES 32
+
 class FxPhaser : public Fx
 {
 public:
 	FxPhaser () = delete;
 
-	FxPhaser (RingBuffer<Stereo>** buffer, float* params, Pad* pads, double* framesPerStep, double rate) :
+	FxPhaser (RingBuffer<Stereo>** buffer, float* params, Pad* pads, double* framesPerStep, double rate, int controlFrames = FX_PHASER_CONTROLFRAMES) :
 		Fx (buffer, params, pads),
 		samplerate (rate),
 		framesPerStepPtr (framesPerStep),
@@ -54,7 +56,11 @@ public:
 		feedback (0.0f),
 		steps (5),
 		minDelta (0),
-		modDelta (0)
+		modDelta (0),
+		controlFrames (controlFrames > 1 ? controlFrames : 1),
+		controlCount (0),
+		coeff (0, 0),
+		coeffDelta (0, 0)
 	{
 		if (!framesPerStep) throw std::invalid_argument ("Fx initialized with framesPerStep nullptr");
 	}
@@ -76,31 +82,28 @@ public:
 
 		minDelta = 0.5 * loFreq / samplerate;
 		modDelta = (hiFreq > loFreq? 0.5 * hiFreq / samplerate - minDelta : 0.0);
-		std::fill (lFilters, lFilters + FX_PHASER_MAXSTEPS, AllPassFilter ());
-		std::fill (rFilters, rFilters + FX_PHASER_MAXSTEPS, AllPassFilter ());
+		std::fill (filters, filters + FX_PHASER_MAXSTEPS, AllPassFilter ());
 		lastSample = Stereo (0, 0);
 		framesPerStep = *framesPerStepPtr;
+		controlCount = 0;
 	}
 
 	virtual Stereo process (const double position, const double size) override
 	{
-		const Stereo s0 = (**buffer).front();
-		const double delayL = minDelta + (0.5 - 0.5 * cos (modRate * position * framesPerStep / samplerate)) * modDelta;
-		const double delayR = minDelta + (0.5 - 0.5 * cos (modPhase + modRate * position * framesPerStep / samplerate)) * modDelta;
-		
-		for (int i = 0; i < steps; ++i)
+		// All stages share the same modulated coefficients. They are
+		// calculated at the control rate and linear interpolated in between.
+		if (controlCount <= 0)
 		{
-			lFilters[i].setDelay (delayL);
-			rFilters[i].setDelay (delayR);
+			coeff = getCoefficients (position);
+			coeffDelta = (framesPerStep > 0.0 ? (getCoefficients (position + controlFrames / framesPerStep) - coeff) / controlFrames : Stereo (0, 0));
+			controlCount = controlFrames;
 		}
+		--controlCount;
 
-		Stereo s1 = s0 + lastSample * feedback;
-		for (int i = steps - 1; i >= 0; --i)
-		{
-			s1.left = lFilters[i].process (s1.left);
-			s1.right = rFilters[i].process (s1.right);
-		}
+		Stereo s1 = (**buffer).front() + lastSample * feedback;
+		for (int i = steps - 1; i >= 0; --i) s1 = filters[i].process (s1, coeff);
 		lastSample = s1;
+		coeff += coeffDelta;
 		return s1;
 	}
 
@@ -114,11 +117,22 @@ protected:
 	double modPhase;
 	float feedback;
 	int steps;
-	AllPassFilter lFilters[FX_PHASER_MAXSTEPS];
-	AllPassFilter rFilters[FX_PHASER_MAXSTEPS];
+	AllPassFilter filters[FX_PHASER_MAXSTEPS];
 	double minDelta;
 	double modDelta;
+	int controlFrames;
+	int controlCount;
+	Stereo coeff;
+	Stereo coeffDelta;
 	Stereo lastSample;
+
+	Stereo getCoefficients (const double position) const
+	{
+		const double phase = modRate * position * framesPerStep / samplerate;
+		const double delayL = minDelta + (0.5 - 0.5 * cos (phase)) * modDelta;
+		const double delayR = minDelta + (0.5 - 0.5 * cos (modPhase + phase)) * modDelta;
+		return Stereo (AllPassFilter::coefficient (delayL), AllPassFilter::coefficient (delayR));
+	}
 };
 
 #endif /* FXPHASER_HPP_ */
@@ -59,6 +59,7 @@ public:
 	{
 		const Stereo s0 = (**buffer).front();
 		const Stereo s1 = process (position, size);
+		wet = s1;
 		return mix (s0, s1, position, size, mixf);
 	}
 
@@ -66,9 +67,12 @@ public:
 	{
 		const Stereo s0 = (**buffer).front();
 		const Stereo s1 = process (position, size);
+		wet = s1;
 		return BUtilities::mix<Stereo> (s0, pan (s0, s1), params[SLOTS_MIX] * mx * mixf);
 	}
 
+	virtual long getTail () const override {return FX_TAIL_DECAY;}
+
 protected:
 	AceReverb reverb;
 	float rsize;
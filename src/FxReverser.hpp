@@ -48,6 +48,8 @@ public:
 		return (**buffer)[rpos];
 	}
 
+	virtual long getTail () const override {return (**buffer).size();}
+
 protected:
 	double* framesPerStepPtr;
 	double framesPerStep;
@@ -81,6 +81,8 @@ public:
 		return BUtilities::mix<Stereo> (s0, s0 * f, ratio);
 	}
 
+	virtual long getTail () const override {return 0;}
+
 protected:
 	double rate;
 	double* framesPerStepPtr;
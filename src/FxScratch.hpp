@@ -55,9 +55,13 @@ public:
 
 	virtual Stereo process (const double position, const double size) override
 	{
-		const double f = shape->getMapValue (fmod (position / reach, 1.0));
-		const double frame = framesPerStep * range * (-LIMIT (f, -1.0, 0.0));
-		return getSample (frame);
+		return getSample (getFrame (position));
+	}
+
+	virtual bool getFrames (const double* positions, const int n, double* frames) override
+	{
+		for (int i = 0; i < n; ++i) frames[i] = getFrame (positions[i]);
+		return true;
 	}
 
 protected:
@@ -66,6 +70,12 @@ protected:
 	Shape<SHAPE_MAXNODES>* shape;
 	double range;
 	double reach;
+
+	double getFrame (const double position) const
+	{
+		const double f = shape->getMapValue (fmod (position / reach, 1.0));
+		return framesPerStep * range * (-LIMIT (f, -1.0, 0.0));
+	}
 };
 
 #endif /* FXSCRATCH_HPP_ */
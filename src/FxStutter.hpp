@@ -72,6 +72,8 @@ public:
 		return s1;
 	}
 
+	virtual long getTail () const override {return (**buffer).size();}
+
 protected:
 	double* framesPerStepPtr;
 	double framesPerStep;
@@ -50,13 +50,24 @@ public:
 
 	virtual Stereo process (const double position, const double size) override
 	{
-		return getSample ((1.0 - speed) * framesPerStep * std::min (position, double (NR_STEPS)));
+		return getSample (getFrame (position));
+	}
+
+	virtual bool getFrames (const double* positions, const int n, double* frames) override
+	{
+		for (int i = 0; i < n; ++i) frames[i] = getFrame (positions[i]);
+		return true;
 	}
 
 protected:
 	double* framesPerStepPtr;
 	double framesPerStep;
 	double speed;
+
+	double getFrame (const double position) const
+	{
+		return (1.0 - speed) * framesPerStep * std::min (position, double (NR_STEPS));
+	}
 };
 
 #endif /* FXTAPESPEED_HPP_ */
@@ -27,6 +27,7 @@
 #define FX_TAPESTOP_REACHRAND 1
 #define FX_TAPESTOP_ORDER 2
 #define FX_TAPESTOP_ORDERRAND 3
+#define FX_TAPESTOP_SEGMENTSIZE 16
 
 class FxTapeStop : public Fx
 {
@@ -37,7 +38,8 @@ public:
 		Fx (buffer, params, pads),
 		framesPerStepPtr (framesPerStep),
 		framesPerStep (24000),
-		reach (1.0), order (1.0), r (0.0)
+		reach (1.0), order (1.0), r (0.0), c (0.0),
+		p0 (1.0), p1 (0.0), d0 (0.0), d1 (0.0), m0 (0.0), m1 (0.0)
 	{
 		if (!framesPerStep) throw std::invalid_argument ("Fx initialized with framesPerStep nullptr");
 	}
@@ -52,11 +54,22 @@ public:
 		const double r2 = bidist (rnd);
 		order = LIMIT (1.0 + 9.0 * (params[SLOTS_OPTPARAMS + FX_TAPESTOP_ORDER] + r2 * params[SLOTS_OPTPARAMS + FX_TAPESTOP_ORDERRAND]), 1.0, 10.0);
 		framesPerStep = *framesPerStepPtr;
+		c = exp (order * reach) - 1.0;
+
+		// Invalidate segment
+		p0 = 1.0;
+		p1 = 0.0;
 	}
 
 	virtual Stereo process (const double position, const double size) override
 	{
-		return getSample ((log (exp (order * std::min (position, double (NR_STEPS))) + exp (order * reach) - 1) / order - reach) * framesPerStep);
+		return getSample (getFrame (position));
+	}
+
+	virtual bool getFrames (const double* positions, const int n, double* frames) override
+	{
+		for (int i = 0; i < n; ++i) frames[i] = getFrame (positions[i]);
+		return true;
 	}
 
 protected:
@@ -65,6 +78,49 @@ protected:
 	double reach;
 	double order;
 	double r;
+	double c;
+	double p0, p1;	// Segment positions
+	double d0, d1;	// Delays at p0, p1
+	double m0, m1;	// Slopes at p0, p1
+
+	/*
+	 * The delay (log (exp (order * pos) + exp (order * reach) - 1) / order
+	 * - reach) * framesPerStep is only calculated at the ends of segments
+	 * of FX_TAPESTOP_SEGMENTSIZE frames. In between, it is cubic Hermite
+	 * interpolated using the exact slopes.
+	 */
+	double getFrame (const double position)
+	{
+		const double p = std::min (position, double (NR_STEPS));
+		if ((p < p0) || (p > p1)) setSegment (p);
+
+		const double h = p1 - p0;
+		const double t = (h > 0.0 ? (p - p0) / h : 0.0);
+		const double t2 = t * t;
+		const double t3 = t2 * t;
+		return
+		(
+			(2.0 * t3 - 3.0 * t2 + 1.0) * d0 +
+			(t3 - 2.0 * t2 + t) * h * m0 +
+			(-2.0 * t3 + 3.0 * t2) * d1 +
+			(t3 - t2) * h * m1
+		);
+	}
+
+	void setSegment (const double position)
+	{
+		p0 = position;
+		p1 = std::min (position + FX_TAPESTOP_SEGMENTSIZE / framesPerStep, double (NR_STEPS));
+		getDelay (p0, d0, m0);
+		getDelay (p1, d1, m1);
+	}
+
+	void getDelay (const double position, double& delay, double& slope) const
+	{
+		const double e = exp (order * position);
+		delay = (log (e + c) / order - reach) * framesPerStep;
+		slope = framesPerStep * e / (e + c);
+	}
 };
 
 #endif /* FXTAPESTOP_HPP_ */
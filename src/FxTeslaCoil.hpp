@@ -21,12 +21,16 @@
 #ifndef FXTESLACOIL_HPP_
 #define FXTESLACOIL_HPP_
 
+#include <vector>
 #include "Fx.hpp"
 
 #define FX_TESLACOIL_DRIVE 0
 #define FX_TESLACOIL_DRIVERAND 1
 #define FX_TESLACOIL_LEVEL 2
 #define FX_TESLACOIL_LEVELRAND 3
+#define FX_TESLACOIL_FREQ 6000.0
+#define FX_TESLACOIL_SINESIZE 1024
+#define FX_TESLACOIL_JITTERSIZE 256
 
 #ifndef SGN
 #define SGN(x) (((x) > 0) - ((x) < 0))
@@ -49,7 +53,15 @@ public:
 		lsign (0.0f),
 		rsign (0.0f),
 		lexc (false),
-		rexc (false)
+		rexc (false),
+		lt (0.0f),
+		rt (0.0f),
+		lpow (0.0f),
+		rpow (0.0f),
+		sine (getSineTable().data()),
+		increments {0.0f},
+		li (0),
+		ri (0)
 	{}
 
 	virtual void init (const double position) override
@@ -67,6 +79,10 @@ public:
 		rt = 0.0f;
 		rpow = 0.0f;
 		lpow = 0.0f;
+
+		// Randomly jittered phase increments, used cyclically from a random
+		// start in each discharge
+		for (float& i : increments) i = (FX_TESLACOIL_FREQ / samplerate) * (1 + 0.25f * bidist (rnd));
 	}
 
 	virtual Stereo process (const double position, const double size) override
@@ -94,6 +110,7 @@ public:
 		{
 			lpow = level;
 			lt = 0.0f;
+			li = unidist (rnd) * FX_TESLACOIL_JITTERSIZE;
 			lexc = true;
 		}
 
@@ -101,22 +118,27 @@ public:
 		{
 			rpow = level;
 			rt = 0.0f;
+			ri = unidist (rnd) * FX_TESLACOIL_JITTERSIZE;
 			rexc = true;
 		}
 
 		// Generate sound
 		if (lpow > 0)
 		{
-			s1.left = lpow * (sinf (2.0f * M_PI * lt) /* + 0.25f * bidist (rnd) */);
-			lt += (6000.0 / samplerate) * (1 + 0.25f * bidist (rnd));
+			s1.left = lpow * getSine (lt);
+			lt += increments[li % FX_TESLACOIL_JITTERSIZE];
+			lt -= int (lt);
+			++li;
 			lpow *= 0.875f;
 			if (lpow < 0.0001f) lpow = 0.0f;
 		}
 
 		if (rpow > 0)
 		{
-			s1.right = rpow * (sinf (2.0f * M_PI * rt) /* + 0.25f * bidist (rnd) */);
-			rt += (6000.0 / samplerate) * (1 + 0.25f * bidist (rnd));
+			s1.right = rpow * getSine (rt);
+			rt += increments[ri % FX_TESLACOIL_JITTERSIZE];
+			rt -= int (rt);
+			++ri;
 			rpow *= 0.875f;
 			if (rpow < 0.0001f) rpow = 0.0f;
 		}
@@ -136,7 +158,31 @@ protected:
 	float rt;
 	float lpow;
 	float rpow;
+	const float* sine;
+	float increments[FX_TESLACOIL_JITTERSIZE];
+	unsigned int li;
+	unsigned int ri;
 
+	// Shared one period sine table (plus guard point)
+	static const std::vector<float>& getSineTable ()
+	{
+		static const std::vector<float> table = []()
+		{
+			std::vector<float> t (FX_TESLACOIL_SINESIZE + 1);
+			for (int i = 0; i <= FX_TESLACOIL_SINESIZE; ++i) t[i] = sin (2.0 * M_PI * double (i) / FX_TESLACOIL_SINESIZE);
+			return t;
+		}();
+		return table;
+	}
+
+	// Linear interpolated sine for phase 0..1
+	float getSine (const float phase) const
+	{
+		const float x = phase * FX_TESLACOIL_SINESIZE;
+		const int i = x;
+		const float f = x - i;
+		return sine[i] + f * (sine[i + 1] - sine[i]);
+	}
 
 };
 
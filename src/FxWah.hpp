@@ -34,12 +34,14 @@
 #define FX_WAH_ORDER 6
 #define FX_WAH_REACH 7
 
+#define FX_WAH_CONTROLFRAMES 32
+
 class FxWah : public Fx
 {
 public:
 	FxWah () = delete;
 
-	FxWah (RingBuffer<Stereo>** buffer, float* params, Pad* pads, double rate, Shape<SHAPE_MAXNODES>* shape) :
+	FxWah (RingBuffer<Stereo>** buffer, float* params, Pad* pads, double rate, Shape<SHAPE_MAXNODES>* shape, int controlFrames = FX_WAH_CONTROLFRAMES) :
 		Fx (buffer, params, pads),
 		rate (rate),
 		shape (shape),
@@ -48,6 +50,8 @@ public:
 		width (0.1f),
 		order (2),
 		reach (1.0),
+		controlFrames (controlFrames > 1 ? controlFrames : 1),
+		controlCount (0),
 		filter (48000, 20, 20000, 8)
 	{
 		if (!shape) throw std::invalid_argument ("Fx initialized with shape nullptr");
@@ -68,17 +72,25 @@ public:
 		const float m = (shape ? shape->getMapValue (0): 0.0);
 		const float f = cFreq * (1 + depth * m);
 		filter = ButterworthBandPassFilter (rate, f * (1.0 - 0.5 * width), f * (1.0 + 0.5 * width), order);
+		controlCount = 0;
 	}
 
 	virtual Stereo process (const double position, const double size) override
 	{
-		const Stereo s0 = (**buffer).front();
-		const float m = shape->getMapValue (fmod (position / reach, 1.0));
-		const float f = cFreq * (1.0f + depth * m);
-		const float fmin = LIMIT (f * (1.0f - width), 0.0f, 20000.0f);
-		const float fmax = LIMIT (f * (1.0f + width), 0.0f, 20000.0f);
-		filter.set (rate, fmin, fmax, order);
-		return filter.push (s0);
+		// Filter coefficients run at the control rate and are ramped within
+		// each control period
+		if (controlCount <= 0)
+		{
+			const float m = shape->getMapValue (fmod (position / reach, 1.0));
+			const float f = cFreq * (1.0f + depth * m);
+			const float fmin = LIMIT (f * (1.0f - width), 0.0f, 20000.0f);
+			const float fmax = LIMIT (f * (1.0f + width), 0.0f, 20000.0f);
+			filter.set (rate, fmin, fmax, order, controlFrames);
+			controlCount = controlFrames;
+		}
+		--controlCount;
+
+		return filter.push ((**buffer).front());
 	}
 
 protected:
@@ -89,6 +101,8 @@ protected:
 	float width;
 	int order;
 	double reach;
+	int controlFrames;
+	int controlCount;
 	ButterworthBandPassFilter filter;
 };
 
@@ -70,32 +70,8 @@ public:
 	virtual Stereo process (const double position, const double size) override
 	{
 		const Stereo s0 = (**buffer).front();
-		float l;
-		float r;
-		float lf;
-		float rf;
-
-		if (unit == 0)
-		{
-			l = fabsf (s0.left * drive);
-			r = fabsf (s0.right * drive);
-			l = LIMIT (l, 0.0f, 1.0f);
-			r = LIMIT (r, 0.0f, 1.0f);
-			lf = shape->getMapValue (l);
-			rf = shape->getMapValue (r);
-		}
-
-		else
-		{
-			l = (90.0f + CO2DB (fabsf (0.000031623f + s0.left * drive))) / 120.0f;
-			r = (90.0f + CO2DB (fabsf (0.000031623f + s0.right * drive))) / 120.0f;
-			l = LIMIT (l, 0.0f, 1.0f);
-			r = LIMIT (r, 0.0f, 1.0f);
-			lf = DB2CO (-90.0f + shape->getMapValue (l) * 120.0f);
-			rf = DB2CO (-90.0f + shape->getMapValue (r) * 120.0f);
-		}
-
-		return Stereo (SGN (s0.left) * lf * gain, SGN (s0.right) * rf * gain);
+		const float l = SGN (s0.left) * getShapeValue (s0.left) * gain;
+		return Stereo (l, (mono > 0 ? l : SGN (s0.right) * getShapeValue (s0.right) * gain));
 	}
 
 protected:
@@ -103,6 +79,20 @@ protected:
 	float drive;
 	float gain;
 	int unit;
+
+	float getShapeValue (const float input) const
+	{
+		if (unit == 0)
+		{
+			float x = fabsf (input * drive);
+			x = LIMIT (x, 0.0f, 1.0f);
+			return shape->getMapValue (x);
+		}
+
+		float x = (90.0f + CO2DB (fabsf (0.000031623f + input * drive))) / 120.0f;
+		x = LIMIT (x, 0.0f, 1.0f);
+		return DB2CO (-90.0f + shape->getMapValue (x) * 120.0f);
+	}
 };
 
 #endif /* FXWAVESHAPER_HPP_ */
@@ -51,6 +51,8 @@ public:
 		return Stereo {m + x, m - x};
 	}
 
+	virtual long getTail () const override {return 0;}
+
 protected:
 	float width;
 
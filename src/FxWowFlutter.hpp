@@ -62,10 +62,13 @@ public:
 
 	virtual Stereo process (const double position, const double size) override
 	{
-		const double wow = (0.5 - 0.5 * cos (2 * M_PI * position * wowRate)) * wowDepth;
-		const double flutter = (0.5 - 0.5 * cos (2 * M_PI * position * flutterRate)) * flutterDepth;
-		const double frame = framesPerStep * (wow + flutter);
-		return getSample (frame);
+		return getSample (getFrame (position));
+	}
+
+	virtual bool getFrames (const double* positions, const int n, double* frames) override
+	{
+		for (int i = 0; i < n; ++i) frames[i] = getFrame (positions[i]);
+		return true;
 	}
 
 protected:
@@ -75,6 +78,13 @@ protected:
 	float wowRate;
 	float flutterDepth;
 	float flutterRate;
+
+	double getFrame (const double position) const
+	{
+		const double wow = (0.5 - 0.5 * cos (2 * M_PI * position * wowRate)) * wowDepth;
+		const double flutter = (0.5 - 0.5 * cos (2 * M_PI * position * flutterRate)) * flutterDepth;
+		return framesPerStep * (wow + flutter);
+	}
 };
 
 #endif /* FXWOWFLUTTER_HPP_ */
@@ -0,0 +1,127 @@
+/* B.Oops
+ * Glitch effect sequencer LV2 plugin
+ *
+ * Copyright (C) 2020 by Sven Jähnichen
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef GLYPHCACHE_HPP_
+#define GLYPHCACHE_HPP_
+
+#include <cairo/cairo.h>
+#include <array>
+#include <map>
+#include <cmath>
+#include "BWidgets/BColors.hpp"
+
+#define GLYPHCACHE_MAXSIZE 512
+#define GLYPHCACHE_MAXPIXELS 0x40000
+#define GLYPHCACHE_SUBPIXELS 4.0
+
+/*
+ * Cache of rasterized glyphs (symbols, buttons). Each glyph is rendered
+ * once per id, device size, color and sub-pixel offset to an image surface
+ * and painted from there afterwards.
+ */
+class GlyphCache
+{
+public:
+	GlyphCache () : glyphs () {}
+	GlyphCache (const GlyphCache& that) = delete;
+	GlyphCache& operator= (const GlyphCache& that) = delete;
+	~GlyphCache () {clear ();}
+
+	void clear ()
+	{
+		for (std::pair<const Key, cairo_surface_t*>& g : glyphs) cairo_surface_destroy (g.second);
+		glyphs.clear ();
+	}
+
+	/*
+	 * Draws a glyph within the area x0, y0, w, h (user space) from the
+	 * cache. Calls render (cr, x0, y0, w, h) to rasterize the glyph if not
+	 * cached yet. Falls back to render directly on cr for skewed or rotated
+	 * contexts and for very large glyphs.
+	 */
+	template <class Func>
+	void draw (cairo_t* cr, const int id, const double x0, const double y0, const double w, const double h, const BColors::Color& color, Func render)
+	{
+		cairo_matrix_t m;
+		cairo_get_matrix (cr, &m);
+		const double dw = w * m.xx;
+		const double dh = h * m.yy;
+		if ((m.xy != 0.0) || (m.yx != 0.0) || (dw <= 0.0) || (dh <= 0.0) || (dw * dh > GLYPHCACHE_MAXPIXELS))
+		{
+			render (cr, x0, y0, w, h);
+			return;
+		}
+
+		// Device position split into integer pixel and quantized sub-pixel offset
+		double ox = x0;
+		double oy = y0;
+		cairo_user_to_device (cr, &ox, &oy);
+		double px = floor (ox);
+		double py = floor (oy);
+		double fx = round ((ox - px) * GLYPHCACHE_SUBPIXELS) / GLYPHCACHE_SUBPIXELS;
+		double fy = round ((oy - py) * GLYPHCACHE_SUBPIXELS) / GLYPHCACHE_SUBPIXELS;
+		if (fx >= 1.0) {px += 1.0; fx = 0.0;}
+		if (fy >= 1.0) {py += 1.0; fy = 0.0;}
+
+		const Key key = {{double (id), dw, dh, m.xx, m.yy, fx, fy, color.getRed (), color.getGreen (), color.getBlue (), color.getAlpha ()}};
+		cairo_surface_t* surface = nullptr;
+		std::map<Key, cairo_surface_t*>::iterator it = glyphs.find (key);
+		if (it != glyphs.end ()) surface = it->second;
+		else
+		{
+			if (glyphs.size () >= GLYPHCACHE_MAXSIZE) clear ();
+
+			surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, ceil (fx + dw) + 1, ceil (fy + dh) + 1);
+			if (cairo_surface_status (surface) != CAIRO_STATUS_SUCCESS)
+			{
+				cairo_surface_destroy (surface);
+				render (cr, x0, y0, w, h);
+				return;
+			}
+
+			cairo_t* gcr = cairo_create (surface);
+			cairo_translate (gcr, fx, fy);
+			cairo_scale (gcr, m.xx, m.yy);
+			render (gcr, 0.0, 0.0, w, h);
+			cairo_destroy (gcr);
+			cairo_surface_flush (surface);
+			glyphs[key] = surface;
+		}
+
+		cairo_save (cr);
+		cairo_new_path (cr);
+		cairo_identity_matrix (cr);
+		cairo_set_source_surface (cr, surface, px, py);
+		cairo_paint (cr);
+		cairo_restore (cr);
+	}
+
+protected:
+	typedef std::array<double, 11> Key;
+	std::map<Key, cairo_surface_t*> glyphs;
+};
+
+inline GlyphCache& getGlyphCache ()
+{
+	static GlyphCache glyphCache;
+	return glyphCache;
+}
+
+#endif /* GLYPHCACHE_HPP_ */
@@ -50,6 +50,12 @@
 #define BOOPS_LABEL_BEATS "Beats"
 #define BOOPS_LABEL_BARS "Takte"
 #define BOOPS_LABEL_STEPS "Schritte"
+#define BOOPS_LABEL_INTERPOLATION "Interpolation"
+#define BOOPS_LABEL_HERMITE "Hermite"
+#define BOOPS_LABEL_SINC "Sinc"
+#define BOOPS_LABEL_INPUT "Eingang"
+#define BOOPS_LABEL_STEREO "Stereo"
+#define BOOPS_LABEL_MONO "Mono"
 #define BOOPS_LABEL_SELECT_KEYS "Fortschrittskontrolle: Tastenauswahl"
 #define BOOPS_LABEL_PROGRESSION_KEYS_TOOLTIP \
         "Mit dieser Option kannst du den Fortschritt im Pattern kontrollieren (weißer Vertikalbalken).\n" \
@@ -50,6 +50,12 @@
 #define BOOPS_LABEL_BEATS "Beats"
 #define BOOPS_LABEL_BARS "Bars"
 #define BOOPS_LABEL_STEPS "Steps"
+#define BOOPS_LABEL_INTERPOLATION "Interpolation"
+#define BOOPS_LABEL_HERMITE "Hermite"
+#define BOOPS_LABEL_SINC "Sinc"
+#define BOOPS_LABEL_INPUT "Input"
+#define BOOPS_LABEL_STEREO "Stereo"
+#define BOOPS_LABEL_MONO "Mono"
 #define BOOPS_LABEL_SELECT_KEYS "Progression control: Select keys"
 #define BOOPS_LABEL_PROGRESSION_KEYS_TOOLTIP \
         "This option is intended for the control of the pattern progression (white vertical bar).\n" \
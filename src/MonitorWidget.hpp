@@ -23,7 +23,10 @@
 
 #include "BWidgets/Widget.hpp"
 #include "Definitions.hpp"
+#include "WaveformBin.hpp"
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
 
 class MonitorWidget : public BWidgets::Widget
 {
@@ -41,11 +44,11 @@ public:
                 setFocusable (false);
         }
 
-        void clear () {data.fill (0.0f);}
+        void clear () {data.fill (WaveformBin {0.0f, 0.0f, 0.0f});}
 
-        void addData (const unsigned int pos, const unsigned int size, const float* data)
+        void addData (const unsigned int pos, const unsigned int size, const int32_t* data)
         {
-                for (unsigned int i = 0; i < size; ++i) this->data[(i + pos) % WAVEFORMSIZE] = data[i];
+                for (unsigned int i = 0; i < size; ++i) this->data[(i + pos) % WAVEFORMSIZE] = unpackWaveformBin (data[i]);
         }
 
         void setZoom (const double factor)
@@ -60,20 +63,9 @@ public:
         {
                 unsigned int s = LIMIT (int (start) - 1, 0, WAVEFORMSIZE - 1);
                 unsigned int e = LIMIT (start + size - 1, 0, WAVEFORMSIZE - 1);
-                double xabs = getAbsolutePosition().x;
-                double yabs = getAbsolutePosition().y;
-                double x1 = getWidth() * s / (WAVEFORMSIZE - 1);
-                double w = getWidth() * (e - s) / (WAVEFORMSIZE - 1);
-                drawData (s, e);
-                if (isVisible ()) postRedisplay (BUtilities::RectArea (floor (xabs + x1), yabs, ceil (w), getHeight()));
-
-                if (start + size > WAVEFORMSIZE)
-                {
-                        unsigned int e2 = (start + size - 1) % WAVEFORMSIZE;
-                        double w2 = getWidth() * e2 / (WAVEFORMSIZE - 1);
-                        drawData (0, e2);
-                        if (isVisible ()) postRedisplay (BUtilities::RectArea (floor (xabs), yabs, ceil (w2), getHeight()));
-                }
+                redrawBins (s, e);
+
+                if (start + size > WAVEFORMSIZE) redrawBins (0, (start + size - 1) % WAVEFORMSIZE);
         }
 
         virtual void applyTheme (BStyles::Theme& theme) override {applyTheme (theme, name_);}
@@ -97,45 +89,97 @@ public:
         }
 
 protected:
-        void drawData (const unsigned int start, const unsigned int end)
+        int binToX (const unsigned int bin) const {return floor (getWidth() * double (bin) / (WAVEFORMSIZE - 1));}
+
+        unsigned int xToBin (const int x) const {return LIMIT (ceil (double (x) * (WAVEFORMSIZE - 1) / getWidth()), 0, WAVEFORMSIZE - 1);}
+
+        void redrawBins (const unsigned int start, const unsigned int end)
+        {
+                const int x0 = binToX (start);
+                const int x1 = binToX (end) + 1;
+                drawColumns (x0, x1);
+                if (isVisible ())
+                {
+                        const BUtilities::Point abs = getAbsolutePosition();
+                        postRedisplay (BUtilities::RectArea (abs.x + x0, abs.y, x1 - x0, getHeight()));
+                }
+        }
+
+        // Render pixel columns [x0, x1) directly into the persistent widget
+        // surface. Each column shows the peak span and the RMS span of all
+        // bins mapped to it.
+        void drawColumns (const int x0, const int x1)
         {
                 if ((!widgetSurface_) || (cairo_surface_status (widgetSurface_) != CAIRO_STATUS_SUCCESS)) return;
+                if (cairo_image_surface_get_format (widgetSurface_) != CAIRO_FORMAT_ARGB32) return;
 
-                BColors::Color col = *fgColors.getColor (getState ());
-        	cairo_t* cr = cairo_create (widgetSurface_);
+                cairo_surface_flush (widgetSurface_);
+                unsigned char* pixels = cairo_image_surface_get_data (widgetSurface_);
+                if (!pixels) return;
 
-        	if (cairo_status (cr) == CAIRO_STATUS_SUCCESS)
-        	{
-        		// Limit cairo-drawing area
-                        cairo_set_line_width (cr, 0);
-                        double x0 = ceil (getWidth() * start / (WAVEFORMSIZE - 1));
-                        double x1 = floor (getWidth() * end / (WAVEFORMSIZE - 1));
-        		cairo_rectangle (cr, x0, 0, x1 - x0, getHeight());
-        		cairo_clip (cr);
-
-        		cairo_set_source_rgba (cr, 0.0, 0.0, 0.0, 0.0);
-        		cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
-        		cairo_paint (cr);
-
-                        cairo_set_line_width (cr, 1);
-                        cairo_move_to (cr, getWidth() * double (start) / (WAVEFORMSIZE - 1), getHeight() * (0.5  - (0.48 * data[start] / zoom)));
-                        for (int i = start + 1; i <= int (end); ++i)
+                const int width = cairo_image_surface_get_width (widgetSurface_);
+                const int height = cairo_image_surface_get_height (widgetSurface_);
+                const int stride = cairo_image_surface_get_stride (widgetSurface_);
+                const int xs = LIMIT (x0, 0, width);
+                const int xe = LIMIT (x1, 0, width);
+                if (xe <= xs) return;
+
+                const BColors::Color col = *fgColors.getColor (getState ());
+                const uint32_t peakColor = premultiply (col, 0.5);
+                const uint32_t rmsColor = premultiply (col, 1.0);
+
+                for (int x = xs; x < xe; ++x)
+                {
+                        // Collect bins of this column
+                        const unsigned int b0 = xToBin (x);
+                        const unsigned int b1 = std::max (xToBin (x + 1), b0 + 1);
+                        WaveformBin bin = data[b0];
+                        for (unsigned int b = b0 + 1; (b < b1) && (b < WAVEFORMSIZE); ++b)
                         {
-                                cairo_line_to (cr, getWidth() * double (i) / (WAVEFORMSIZE - 1), getHeight() * (0.5  - (0.48 * data[i] / zoom)));
+                                bin.min = std::min (bin.min, data[b].min);
+                                bin.max = std::max (bin.max, data[b].max);
+                                bin.rms = std::max (bin.rms, data[b].rms);
                         }
-                        cairo_set_source_rgba (cr, CAIRO_RGBA (col));
-                        cairo_stroke (cr);
 
-                        cairo_destroy (cr);
+                        const int yMax = valueToY (bin.max, height);
+                        const int yMin = valueToY (bin.min, height);
+                        const int yRmsTop = valueToY (bin.rms, height);
+                        const int yRmsBottom = valueToY (-bin.rms, height);
+
+                        for (int y = 0; y < height; ++y)
+                        {
+                                uint32_t* pixel = (uint32_t*) (pixels + y * stride) + x;
+                                if ((y >= yRmsTop) && (y <= yRmsBottom)) *pixel = rmsColor;
+                                else if ((y >= yMax) && (y <= yMin)) *pixel = peakColor;
+                                else *pixel = 0;
+                        }
                 }
+
+                cairo_surface_mark_dirty_rectangle (widgetSurface_, xs, 0, xe - xs, height);
+        }
+
+        int valueToY (const float value, const int height) const {return LIMIT (height * (0.5  - (0.48 * value / zoom)), 0, height - 1);}
+
+        static uint32_t premultiply (const BColors::Color& col, const double alpha)
+        {
+                const double a = col.getAlpha() * alpha;
+                return
+                (
+                        (uint32_t (a * 255.0) << 24) |
+                        (uint32_t (col.getRed() * a * 255.0) << 16) |
+                        (uint32_t (col.getGreen() * a * 255.0) << 8) |
+                        uint32_t (col.getBlue() * a * 255.0)
+                );
         }
 
+        // Full redraw only on zoom, resize or theme change
         virtual void draw (const BUtilities::RectArea& area) override
         {
-                drawData (0, WAVEFORMSIZE - 1);
+                scheduleDraw_ = false;
+                drawColumns (0, getWidth());
         }
 
-        std::array<float, WAVEFORMSIZE> data;
+        std::array<WaveformBin, WAVEFORMSIZE> data;
         BColors::ColorSet fgColors;
         double zoom;
 };
@@ -42,6 +42,35 @@ public:
                 add (focusText);
         }
 
+        /*
+         * Copies a region (drawing surface coordinates) of the drawing surface
+         * to the widget surface and posts a redisplay of this region only.
+         * Falls back to update () if a full redraw is already pending.
+         */
+        void updateArea (const BUtilities::RectArea& area)
+        {
+                if (scheduleDraw_) {update (); return;}
+                if ((!widgetSurface_) || (cairo_surface_status (widgetSurface_) != CAIRO_STATUS_SUCCESS)) return;
+
+                const double x0 = getXOffset ();
+                const double y0 = getYOffset ();
+                cairo_t* cr = cairo_create (widgetSurface_);
+                if (cairo_status (cr) == CAIRO_STATUS_SUCCESS)
+                {
+                        cairo_rectangle (cr, x0 + area.getX (), y0 + area.getY (), area.getWidth (), area.getHeight ());
+                        cairo_clip (cr);
+                        cairo_set_source_surface (cr, drawingSurface, x0, y0);
+                        cairo_paint (cr);
+                }
+                cairo_destroy (cr);
+
+                if (isVisible ())
+                {
+                        BUtilities::Point abs = getAbsolutePosition ();
+                        postRedisplay (BUtilities::RectArea (abs.x + x0 + area.getX (), abs.y + y0 + area.getY (), area.getWidth (), area.getHeight ()));
+                }
+        }
+
         virtual void onFocusIn (BEvents::FocusEvent* event) override
         {
                 Widget::onFocusIn (event);
@@ -60,7 +60,7 @@ void Pattern::setPad (const size_t row, const size_t step, const Pad& pad)
 	pads[r][s] = pad;
 }
 
-Shape<SHAPE_MAXNODES> Pattern::getShape(const size_t row) const
+const Shape<SHAPE_MAXNODES>& Pattern::getShape(const size_t row) const
 {
         return shapes[LIMIT (row, 0, NR_SLOTS - 1)];
 }
@@ -53,7 +53,7 @@ public:
         void clear ();
         Pad getPad (const size_t row, const size_t step) const;
         void setPad (const size_t row, const size_t step, const Pad& pad);
-        Shape<SHAPE_MAXNODES> getShape(const size_t row) const;
+        const Shape<SHAPE_MAXNODES>& getShape(const size_t row) const;
         void setShape (const size_t row, const Shape<SHAPE_MAXNODES>& shape);
         std::array<bool, NR_PIANO_KEYS + 1> getKeys (const size_t row) const;
         bool getKey (const size_t row, const size_t note) const;
@@ -0,0 +1,110 @@
+/* B.Oops
+ * Glitch effect sequencer LV2 plugin
+ *
+ * Copyright (C) 2020 by Sven Jähnichen
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef PEAKDATA_HPP_
+#define PEAKDATA_HPP_
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#define PEAKDATA_BINSIZE 64
+
+struct PeakBin
+{
+	float min;
+	float max;
+
+	void add (const PeakBin& bin)
+	{
+		if (bin.min < min) min = bin.min;
+		if (bin.max > max) max = bin.max;
+	}
+};
+
+/*
+ * Min / max peak pyramid of a sample (all channels). Level 0 contains one
+ * bin per PEAKDATA_BINSIZE frames, each further level halves the number of
+ * bins of the previous level.
+ */
+struct PeakData
+{
+	int64_t frames;
+	int samplerate;
+	int channels;
+	std::vector<std::vector<PeakBin>> levels;
+
+	PeakData () : frames (0), samplerate (0), channels (0), levels () {}
+
+	/*
+	 * Builds the higher levels from level 0.
+	 */
+	void buildLevels ()
+	{
+		levels.resize (1);
+		while (levels.back().size() > 1)
+		{
+			const std::vector<PeakBin>& lower = levels.back();
+			std::vector<PeakBin> upper;
+			upper.reserve ((lower.size() + 1) / 2);
+			for (size_t i = 0; i < lower.size(); i += 2)
+			{
+				PeakBin bin = lower[i];
+				if (i + 1 < lower.size()) bin.add (lower[i + 1]);
+				upper.push_back (bin);
+			}
+			levels.push_back (std::move (upper));
+		}
+	}
+
+	/*
+	 * Gets the min / max peaks within the frame range [frame0, frame1) from
+	 * the coarsest level that still resolves the range.
+	 */
+	PeakBin get (const double frame0, const double frame1) const
+	{
+		if (levels.empty() || levels[0].empty()) return PeakBin {0.0f, 0.0f};
+
+		const double span = frame1 - frame0;
+		size_t level = 0;
+		while ((level + 1 < levels.size()) && (double (int64_t (PEAKDATA_BINSIZE) << (level + 1)) <= span)) ++level;
+
+		const std::vector<PeakBin>& bins = levels[level];
+		const double binsize = double (int64_t (PEAKDATA_BINSIZE) << level);
+		const int64_t last = bins.size() - 1;
+		int64_t b0 = floor (frame0 / binsize);
+		int64_t b1 = ceil (frame1 / binsize) - 1;
+		b0 = (b0 < 0 ? 0 : (b0 > last ? last : b0));
+		b1 = (b1 < b0 ? b0 : (b1 > last ? last : b1));
+
+		PeakBin bin = bins[b0];
+		for (int64_t i = b0 + 1; i <= b1; ++i) bin.add (bins[i]);
+		return bin;
+	}
+
+	float getMaxAbs () const
+	{
+		if (levels.empty() || levels.back().empty()) return 0.0f;
+		const PeakBin& bin = levels.back()[0];
+		return (fabsf (bin.min) > fabsf (bin.max) ? fabsf (bin.min) : fabsf (bin.max));
+	}
+};
+
+#endif /* PEAKDATA_HPP_ */
@@ -0,0 +1,505 @@
+/* B.Oops
+ * Glitch effect sequencer LV2 plugin
+ *
+ * Copyright (C) 2020 by Sven Jähnichen
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef PEAKLOADER_HPP_
+#define PEAKLOADER_HPP_
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <vector>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "PeakData.hpp"
+#include "Sample.hpp"
+
+#define PEAKLOADER_BLOCKSIZE 4096
+#define PEAKLOADER_MAGIC 0x4b504f42
+#define PEAKLOADER_VERSION 1
+#define PEAKLOADER_MAXSAMPLERATE 1536000
+#define PEAKLOADER_MAXCHANNELS 256
+
+/*
+ * Sample file kept open for repeated reads of frame ranges. Thus MP3 files
+ * are only indexed once. Not thread-safe, use from one thread at a time.
+ */
+class SampleReader
+{
+public:
+	SampleReader (const std::string& samplepath) :
+		path (samplepath), opened (false), channels (0), sndfile (nullptr) {}
+
+	SampleReader (const SampleReader& that) = delete;
+	SampleReader& operator= (const SampleReader& that) = delete;
+	~SampleReader () {close ();}
+
+	/*
+	 * Reads up to count frames from start on into buffer (interleaved).
+	 * Returns the number of channels or 0 on error.
+	 */
+	int read (const int64_t start, const int64_t count, std::vector<float>& buffer)
+	{
+		if ((start < 0) || (count <= 0) || (!open ())) return 0;
+
+#ifndef SF_FORMAT_MP3
+		if (mp3)
+		{
+			if (mp3dec_ex_seek (&dec, start * channels)) return 0;
+			buffer.resize (count * channels);
+			const size_t n = mp3dec_ex_read (&dec, buffer.data(), buffer.size());
+			buffer.resize (n - n % channels);
+			return channels;
+		}
+#endif /* !SF_FORMAT_MP3 */
+
+		if (sf_seek (sndfile, start, SEEK_SET) < 0) return 0;
+		buffer.resize (count * channels);
+		const sf_count_t n = sf_readf_float (sndfile, buffer.data(), count);
+		buffer.resize ((n > 0 ? n : 0) * channels);
+		return channels;
+	}
+
+	static bool isMp3 (const std::string& samplepath)
+	{
+		const size_t pos = samplepath.find_last_of ('.');
+		if (pos == std::string::npos) return false;
+		std::string ext = samplepath.substr (pos);
+		for (char& c : ext) c = tolower ((unsigned char) c);
+		return (ext == ".mp3");
+	}
+
+protected:
+	std::string path;
+	bool opened;
+	bool mp3;
+	int channels;
+	SNDFILE* sndfile;
+#ifndef SF_FORMAT_MP3
+	mp3dec_ex_t dec;
+#endif /* !SF_FORMAT_MP3 */
+
+	bool open ()
+	{
+		if (opened) return (channels > 0);
+		opened = true;
+		mp3 = false;
+
+#ifndef SF_FORMAT_MP3
+		if (isMp3 (path))
+		{
+			if (mp3dec_ex_open (&dec, path.c_str(), MP3D_SEEK_TO_SAMPLE)) return false;
+			mp3 = true;
+			channels = dec.info.channels;
+			return (channels > 0);
+		}
+#endif /* !SF_FORMAT_MP3 */
+
+		SF_INFO info {0, 0, 0, 0, 0, 0};
+		sndfile = sf_open (path.c_str(), SFM_READ, &info);
+		if (sf_error (sndfile) != SF_ERR_NO_ERROR)
+		{
+			if (sndfile) sf_close (sndfile);
+			sndfile = nullptr;
+			return false;
+		}
+		channels = info.channels;
+		return (channels > 0);
+	}
+
+	void close ()
+	{
+#ifndef SF_FORMAT_MP3
+		if (opened && mp3) mp3dec_ex_close (&dec);
+#endif /* !SF_FORMAT_MP3 */
+		if (sndfile) sf_close (sndfile);
+		sndfile = nullptr;
+		opened = false;
+	}
+};
+
+/*
+ * Background job to read the frames [start, start + count) of a sample file
+ * and to reduce them to nrBins min / max bins. Used for zoom levels below
+ * PEAKDATA_BINSIZE frames per bin.
+ */
+struct DetailLoader
+{
+	std::shared_ptr<SampleReader> reader;
+	int64_t start;
+	int64_t count;
+	int nrBins;
+	std::vector<PeakBin> bins;
+	bool ok;
+	std::atomic<bool> done;
+
+	DetailLoader (std::shared_ptr<SampleReader> samplereader, const int64_t start, const int64_t count, const int nrBins) :
+		reader (samplereader), start (start), count (count), nrBins (nrBins),
+		bins (), ok (false), done (false) {}
+
+	static void run (std::shared_ptr<DetailLoader> loader)
+	{
+		try {loader->ok = read (*loader);}
+		catch (const std::exception&) {loader->ok = false;}
+		if (!loader->ok) loader->bins.clear ();
+		loader->done = true;
+	}
+
+protected:
+	static bool read (DetailLoader& loader)
+	{
+		if (loader.nrBins <= 0) return false;
+		std::vector<float> buffer;
+		const int channels = loader.reader->read (loader.start, loader.count, buffer);
+		if (channels <= 0) return false;
+
+		std::vector<PeakBin>& bins = loader.bins;
+		bins.assign (loader.nrBins, PeakBin {0.0f, 0.0f});
+		const int64_t frames = buffer.size() / channels;
+		for (int i = 0; i < loader.nrBins; ++i)
+		{
+			const int64_t f0 = (i * loader.count) / loader.nrBins;
+			int64_t f1 = ((i + 1) * loader.count) / loader.nrBins;
+			if (f1 <= f0) f1 = f0 + 1;
+			if (f0 >= frames) break;
+			bins[i] = PeakBin {buffer[f0 * channels], buffer[f0 * channels]};
+			for (int64_t f = f0; (f < f1) && (f < frames); ++f)
+			{
+				for (int c = 0; c < channels; ++c)
+				{
+					const float v = buffer[f * channels + c];
+					bins[i].add (PeakBin {v, v});
+				}
+			}
+		}
+
+		return true;
+	}
+};
+
+/*
+ * Background job to provide the peak pyramid of a sample file. Peaks are
+ * read from the peak cache directory if present and up to date. Otherwise
+ * the sample file is decoded block by block and the result is stored in
+ * the cache. run () first publishes the sample header (levels empty) and
+ * then the full pyramid.
+ */
+struct PeakLoader
+{
+	std::string path;
+	std::atomic<bool> cancelled;
+	std::atomic<bool> done;
+	std::mutex mutex;
+	std::shared_ptr<const PeakData> data;
+	std::string error;
+	unsigned int version;
+	bool finished;
+
+	PeakLoader (const std::string& samplepath) :
+		path (samplepath), cancelled (false), done (false), mutex (),
+		data (), error (), version (0), finished (false) {}
+
+	static void run (std::shared_ptr<PeakLoader> loader)
+	{
+		std::shared_ptr<PeakData> peaks = std::make_shared<PeakData> ();
+		std::string err = "";
+
+		try
+		{
+			const std::string cacheFile = getCacheFileName (loader->path);
+			if (!load (cacheFile, *peaks))
+			{
+				if (decode (*loader, *peaks, err) && (!loader->cancelled)) save (cacheFile, *peaks);
+			}
+		}
+
+		catch (const std::exception& e)
+		{
+			peaks = std::make_shared<PeakData> ();
+			err = "Can't load peaks: " + std::string (e.what ());
+		}
+
+		std::lock_guard<std::mutex> lock (loader->mutex);
+		loader->data = peaks;
+		loader->error = err;
+		++loader->version;
+		loader->finished = true;
+		loader->done = true;
+	}
+
+	/*
+	 * Synchronously gets the peaks from the cache. Returns nullptr if not
+	 * cached.
+	 */
+	static std::shared_ptr<const PeakData> getCached (const std::string& samplepath)
+	{
+		std::shared_ptr<PeakData> peaks = std::make_shared<PeakData> ();
+		if (load (getCacheFileName (samplepath), *peaks)) return peaks;
+		return nullptr;
+	}
+
+protected:
+	/*
+	 * Decodes the sample file block by block and builds the peak pyramid.
+	 */
+	static bool decode (PeakLoader& loader, PeakData& peaks, std::string& err)
+	{
+		const std::string name = loader.path.substr (loader.path.find_last_of ('/') + 1);
+		std::vector<float> buffer;
+		peaks.levels.resize (1);
+		std::vector<PeakBin>& bins = peaks.levels[0];
+		PeakBin bin {0.0f, 0.0f};
+		int64_t binCount = 0;
+
+		auto addFrames = [&] (const float* data, const int64_t n)
+		{
+			for (int64_t f = 0; f < n; ++f)
+			{
+				for (int c = 0; c < peaks.channels; ++c)
+				{
+					const float v = data[f * peaks.channels + c];
+					if ((binCount == 0) && (c == 0)) bin = PeakBin {v, v};
+					else bin.add (PeakBin {v, v});
+				}
+
+				++binCount;
+				if (binCount == PEAKDATA_BINSIZE)
+				{
+					bins.push_back (bin);
+					binCount = 0;
+				}
+			}
+		};
+
+#ifndef SF_FORMAT_MP3
+		if (SampleReader::isMp3 (loader.path))
+		{
+			mp3dec_ex_t dec;
+			if (mp3dec_ex_open (&dec, loader.path.c_str(), MP3D_SEEK_TO_SAMPLE) || (dec.info.channels <= 0))
+			{
+				err = "Can't open " + name + ".";
+				return false;
+			}
+
+			if (dec.samples < (uint64_t) dec.info.channels)
+			{
+				mp3dec_ex_close (&dec);
+				err = "Empty sample file " + name + ".";
+				return false;
+			}
+
+			peaks.samplerate = dec.info.hz;
+			peaks.channels = dec.info.channels;
+			peaks.frames = dec.samples / dec.info.channels;
+			publishHeader (loader, peaks);
+
+			buffer.resize (PEAKLOADER_BLOCKSIZE * peaks.channels);
+			size_t n;
+			while ((!loader.cancelled) && ((n = mp3dec_ex_read (&dec, buffer.data(), buffer.size())) > 0))
+			{
+				addFrames (buffer.data(), n / peaks.channels);
+			}
+			mp3dec_ex_close (&dec);
+		}
+
+		else
+#endif /* !SF_FORMAT_MP3 */
+
+		{
+			SF_INFO info {0, 0, 0, 0, 0, 0};
+			SNDFILE* sndfile = sf_open (loader.path.c_str(), SFM_READ, &info);
+			if (sf_error (sndfile) != SF_ERR_NO_ERROR)
+			{
+				err = std::string (sf_strerror (sndfile));
+				return false;
+			}
+
+			if ((!info.frames) || (info.channels <= 0))
+			{
+				sf_close (sndfile);
+				err = "Empty sample file " + name + ".";
+				return false;
+			}
+
+			peaks.samplerate = info.samplerate;
+			peaks.channels = info.channels;
+			peaks.frames = info.frames;
+			publishHeader (loader, peaks);
+
+			buffer.resize (PEAKLOADER_BLOCKSIZE * peaks.channels);
+			sf_count_t n;
+			while ((!loader.cancelled) && ((n = sf_readf_float (sndfile, buffer.data(), PEAKLOADER_BLOCKSIZE)) > 0))
+			{
+				addFrames (buffer.data(), n);
+			}
+			sf_close (sndfile);
+		}
+
+		if (binCount) bins.push_back (bin);
+		if (loader.cancelled) return false;
+		peaks.buildLevels ();
+		return true;
+	}
+
+	static void publishHeader (PeakLoader& loader, const PeakData& peaks)
+	{
+		std::shared_ptr<PeakData> header = std::make_shared<PeakData> ();
+		header->frames = peaks.frames;
+		header->samplerate = peaks.samplerate;
+		header->channels = peaks.channels;
+
+		std::lock_guard<std::mutex> lock (loader.mutex);
+		loader.data = header;
+		++loader.version;
+	}
+
+	static std::string getCacheDir ()
+	{
+		const char* xdg = getenv ("XDG_CACHE_HOME");
+		if (xdg && xdg[0]) return std::string (xdg) + "/BOops/peaks";
+		const char* home = getenv ("HOME");
+		if (home && home[0]) return std::string (home) + "/.cache/BOops/peaks";
+		return "";
+	}
+
+	/*
+	 * Cache file name from hashing the sample path, size and modification
+	 * time. Thus changed sample files invalidate their cache file.
+	 */
+	static std::string getCacheFileName (const std::string& samplepath)
+	{
+		const std::string dir = getCacheDir ();
+		struct stat sb;
+		if ((dir == "") || stat (samplepath.c_str(), &sb)) return "";
+
+		const std::string key = samplepath + "\n" + std::to_string (sb.st_size) + "\n" + std::to_string (sb.st_mtime);
+		uint64_t hash = 0xcbf29ce484222325ULL;
+		for (const char c : key)
+		{
+			hash ^= (unsigned char) c;
+			hash *= 0x100000001b3ULL;
+		}
+
+		char hex[17];
+		snprintf (hex, 17, "%016llx", (unsigned long long) hash);
+		return dir + "/" + hex + ".peaks";
+	}
+
+	static bool load (const std::string& cacheFile, PeakData& peaks)
+	{
+		if (cacheFile == "") return false;
+		FILE* file = fopen (cacheFile.c_str(), "rb");
+		if (!file) return false;
+
+		uint32_t header[2];
+		int64_t frames;
+		int32_t format[2];
+		uint32_t nrBins;
+		bool ok =
+		(
+			(fread (header, sizeof (header), 1, file) == 1) &&
+			(header[0] == PEAKLOADER_MAGIC) && (header[1] == PEAKLOADER_VERSION) &&
+			(fread (&frames, sizeof (frames), 1, file) == 1) &&
+			(fread (format, sizeof (format), 1, file) == 1) &&
+			(fread (&nrBins, sizeof (nrBins), 1, file) == 1) &&
+			(frames > 0) &&
+			(format[0] > 0) && (format[0] <= PEAKLOADER_MAXSAMPLERATE) &&
+			(format[1] > 0) && (format[1] <= PEAKLOADER_MAXCHANNELS) &&
+			(uint64_t (nrBins) == (uint64_t (frames) + PEAKDATA_BINSIZE - 1) / PEAKDATA_BINSIZE) &&
+			(getRemainingSize (file) == int64_t (nrBins) * int64_t (sizeof (PeakBin)))
+		);
+
+		if (ok)
+		{
+			peaks.levels.resize (1);
+			peaks.levels[0].resize (nrBins);
+			ok = (fread (peaks.levels[0].data(), sizeof (PeakBin), nrBins, file) == nrBins);
+		}
+		fclose (file);
+		if (!ok) return false;
+
+		peaks.frames = frames;
+		peaks.samplerate = format[0];
+		peaks.channels = format[1];
+		peaks.buildLevels ();
+		return true;
+	}
+
+	static int64_t getRemainingSize (FILE* file)
+	{
+		const long pos = ftell (file);
+		if ((pos < 0) || (fseek (file, 0, SEEK_END) != 0)) return -1;
+		const long end = ftell (file);
+		if (fseek (file, pos, SEEK_SET) != 0) return -1;
+		return end - pos;
+	}
+
+	static bool save (const std::string& cacheFile, const PeakData& peaks)
+	{
+		if ((cacheFile == "") || peaks.levels.empty()) return false;
+
+		// Create cache directory
+		const std::string dir = cacheFile.substr (0, cacheFile.find_last_of ('/'));
+		for (size_t pos = dir.find ('/', 1); ; pos = dir.find ('/', pos + 1))
+		{
+			mkdir (dir.substr (0, pos).c_str(), 0755);
+			if (pos == std::string::npos) break;
+		}
+
+		// Write to a temporary file first to not leave incomplete cache files
+		std::string tmpFile = cacheFile + ".XXXXXX";
+		const int fd = mkstemp (&tmpFile[0]);
+		if (fd < 0) return false;
+		FILE* file = fdopen (fd, "wb");
+		if (!file)
+		{
+			close (fd);
+			remove (tmpFile.c_str());
+			return false;
+		}
+
+		const uint32_t header[2] = {PEAKLOADER_MAGIC, PEAKLOADER_VERSION};
+		const int64_t frames = peaks.frames;
+		const int32_t format[2] = {peaks.samplerate, peaks.channels};
+		const uint32_t nrBins = peaks.levels[0].size();
+		const bool ok =
+		(
+			(fwrite (header, sizeof (header), 1, file) == 1) &&
+			(fwrite (&frames, sizeof (frames), 1, file) == 1) &&
+			(fwrite (format, sizeof (format), 1, file) == 1) &&
+			(fwrite (&nrBins, sizeof (nrBins), 1, file) == 1) &&
+			(fwrite (peaks.levels[0].data(), sizeof (PeakBin), nrBins, file) == nrBins)
+		);
+
+		if ((fclose (file) != 0) || (!ok) || (rename (tmpFile.c_str(), cacheFile.c_str()) != 0))
+		{
+			remove (tmpFile.c_str());
+			return false;
+		}
+
+		return true;
+	}
+};
+
+#endif /* PEAKLOADER_HPP_ */
@@ -58,7 +58,10 @@ enum BOopsPortIndex
 	NR_PARAMS	= SLOTS_OPTPARAMS + NR_OPTPARAMS,
 	NR_SLOTS	= 12,
 
-	NR_CONTROLLERS	= SLOTS + (SLOTS_PARAMS + SLOTS_OPTPARAMS + NR_OPTPARAMS) * NR_SLOTS
+	INTERPOLATION	= SLOTS + (SLOTS_PARAMS + SLOTS_OPTPARAMS + NR_OPTPARAMS) * NR_SLOTS,
+	FORCE_MONO	= INTERPOLATION + 1,
+
+	NR_CONTROLLERS	= FORCE_MONO + 1
 };
 
 enum BOopsPlayIndex
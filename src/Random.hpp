@@ -0,0 +1,121 @@
+/* B.Oops
+ * Glitch effect sequencer LV2 plugin
+ *
+ * Copyright (C) 2020 by Sven Jähnichen
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef RANDOM_HPP_
+#define RANDOM_HPP_
+
+#include <cstdint>
+#include <cstddef>
+
+#define FASTRANDOM_LANES 8
+
+/*
+ * Fast pseudo random number generator made of FASTRANDOM_LANES interleaved
+ * xorshift32 generators. Single draws rotate through the lanes, fill ()
+ * advances all lanes at once (and can be vectorized by the compiler).
+ * Satisfies the UniformRandomBitGenerator requirements.
+ */
+class FastRandom
+{
+public:
+	typedef uint32_t result_type;
+
+	static constexpr result_type min () {return 1;}
+	static constexpr result_type max () {return 0xFFFFFFFF;}
+
+	explicit FastRandom (const uint32_t value = 1) : state {0}, lane (0) {seed (value);}
+
+	void seed (const uint32_t value)
+	{
+		// Lane states from SplitMix64, never zero
+		uint64_t z = value;
+		for (uint32_t& s : state)
+		{
+			z += 0x9E3779B97F4A7C15ull;
+			uint64_t x = z;
+			x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+			x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+			s = uint32_t (x ^ (x >> 31)) | 1;
+		}
+		lane = 0;
+	}
+
+	result_type operator() ()
+	{
+		uint32_t s = state[lane];
+		s ^= s << 13;
+		s ^= s >> 17;
+		s ^= s << 5;
+		state[lane] = s;
+		lane = (lane + 1) % FASTRANDOM_LANES;
+		return s;
+	}
+
+	// Uniform float in [0, 1)
+	static float toFloat (const uint32_t value) {return float (value >> 8) * (1.0f / 16777216.0f);}
+
+	/*
+	 * Fills dest with n uniform random values in [lo, hi).
+	 */
+	void fill (float* dest, const size_t n, const float lo = 0.0f, const float hi = 1.0f)
+	{
+		const float f = (hi - lo) * (1.0f / 16777216.0f);
+		size_t i = 0;
+
+		// Single values until the lanes are aligned, then all lanes at once
+		for (; (i < n) && (lane != 0); ++i) dest[i] = lo + f * float ((*this)() >> 8);
+		for (; i + FASTRANDOM_LANES <= n; i += FASTRANDOM_LANES)
+		{
+			for (int j = 0; j < FASTRANDOM_LANES; ++j)
+			{
+				uint32_t s = state[j];
+				s ^= s << 13;
+				s ^= s >> 17;
+				s ^= s << 5;
+				state[j] = s;
+				dest[i + j] = lo + f * float (s >> 8);
+			}
+		}
+
+		for (; i < n; ++i) dest[i] = lo + f * float ((*this)() >> 8);
+	}
+
+protected:
+	uint32_t state[FASTRANDOM_LANES];
+	int lane;
+};
+
+/*
+ * Uniform float distribution in [a, b) for FastRandom. Same use as
+ * std::uniform_real_distribution<float>, but without its overhead.
+ */
+class FastUniform
+{
+public:
+	FastUniform (const float a, const float b) : a (a), f (b - a) {}
+
+	float operator() (FastRandom& rnd) const {return a + f * FastRandom::toFloat (rnd());}
+
+protected:
+	float a;
+	float f;
+};
+
+#endif /* RANDOM_HPP_ */
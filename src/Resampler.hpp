@@ -0,0 +1,307 @@
+/* B.Oops
+ * Glitch effect sequencer LV2 plugin
+ *
+ * Copyright (C) 2020 by Sven Jähnichen
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef RESAMPLER_HPP_
+#define RESAMPLER_HPP_
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include "Stereo.hpp"
+#include "RingBuffer.hpp"
+
+#define RESAMPLER_HERMITE 0
+#define RESAMPLER_SINC 1
+#define RESAMPLER_SINC_TAPS 8
+#define RESAMPLER_SINC_PHASES 256
+
+#ifndef RESAMPLER_DEFAULT_QUALITY
+#define RESAMPLER_DEFAULT_QUALITY RESAMPLER_HERMITE
+#endif
+
+#if defined (__SSE__) || defined (__x86_64__) || defined (_M_X64)
+#include <xmmintrin.h>
+#define RESAMPLER_SSE
+#endif
+
+/*
+ * Interpolated (fractional) read from a ring buffer of stereo frames for
+ * the buffer-reading effects. Each read copies the needed window of
+ * frames in one go (RingBuffer::get) and applies a 4-point Hermite or an
+ * 8-tap Blackman-windowed sinc kernel. The sinc kernel is taken from a
+ * shared table of RESAMPLER_SINC_PHASES fractional positions. The quality
+ * is chosen per call. With SSE, both channels (sinc) or two frames
+ * (Hermite block reads) are calculated in parallel lanes. All ways of
+ * reading give the same result for the same frame.
+ */
+class Resampler
+{
+public:
+	/*
+	 * Gets the frame at the (fractional) position frame (0 = front, newest)
+	 * from buffer.
+	 */
+	static Stereo get (const RingBuffer<Stereo>& buffer, const double frame, const int quality = RESAMPLER_DEFAULT_QUALITY)
+	{
+		const long f = frame;
+		const float x = frame - double (f);
+		if (x == 0.0f) return buffer[f];
+
+		Stereo w[RESAMPLER_SINC_TAPS];
+
+		if (f < 1)
+		{
+			buffer.get (f, w, 2);
+			return BUtilities::mix<Stereo> (w[0], w[1], x);
+		}
+
+		if ((quality == RESAMPLER_SINC) && (f >= RESAMPLER_SINC_TAPS / 2 - 1))
+		{
+			buffer.get (f - (RESAMPLER_SINC_TAPS / 2 - 1), w, RESAMPLER_SINC_TAPS);
+			return sinc (w, x);
+		}
+
+		buffer.get (f - 1, w, 4);
+		return hermite (w, x);
+	}
+
+	/*
+	 * Gets n frames at the (fractional) positions frames (0 = front,
+	 * newest) from buffer. Same result as n calls of get ().
+	 */
+	static void get (const RingBuffer<Stereo>& buffer, const double* frames, Stereo* dest, const int n, const int quality = RESAMPLER_DEFAULT_QUALITY)
+	{
+		int i = 0;
+
+#ifdef RESAMPLER_SSE
+		// Hermite: two frames at once
+		if (quality != RESAMPLER_SINC)
+		{
+			for (; i + 1 < n; i += 2)
+			{
+				const long f0 = frames[i];
+				const long f1 = frames[i + 1];
+				const float x0 = frames[i] - double (f0);
+				const float x1 = frames[i + 1] - double (f1);
+				if ((f0 < 1) || (f1 < 1) || (x0 == 0.0f) || (x1 == 0.0f))
+				{
+					dest[i] = get (buffer, frames[i], quality);
+					dest[i + 1] = get (buffer, frames[i + 1], quality);
+					continue;
+				}
+
+				Stereo w0[4];
+				Stereo w1[4];
+				buffer.get (f0 - 1, w0, 4);
+				buffer.get (f1 - 1, w1, 4);
+				hermite2 (w0, w1, x0, x1, dest + i);
+			}
+		}
+#endif /* RESAMPLER_SSE */
+
+		for (; i < n; ++i) dest[i] = get (buffer, frames[i], quality);
+	}
+
+	/*
+	 * Same as get (), but only calculates the left channel. For frames with
+	 * identical channels.
+	 */
+	static Stereo getMono (const RingBuffer<Stereo>& buffer, const double frame, const int quality = RESAMPLER_DEFAULT_QUALITY)
+	{
+		const long f = frame;
+		const float x = frame - double (f);
+		if (x == 0.0f) return buffer[f];
+
+		Stereo w[RESAMPLER_SINC_TAPS];
+		float l;
+
+		if (f < 1)
+		{
+			buffer.get (f, w, 2);
+			l = w[1].left * x + w[0].left * (1.0f - x);
+		}
+
+		else if ((quality == RESAMPLER_SINC) && (f >= RESAMPLER_SINC_TAPS / 2 - 1))
+		{
+			buffer.get (f - (RESAMPLER_SINC_TAPS / 2 - 1), w, RESAMPLER_SINC_TAPS);
+			const float* k0;
+			const float* k1;
+			float p;
+			getSincKernels (x, k0, k1, p);
+
+			// Even and odd taps summed separately, like sinc ()
+			float le = 0.0f;
+			float lo = 0.0f;
+			for (int j = 0; j < RESAMPLER_SINC_TAPS; j += 2)
+			{
+				le += (k0[j] + p * (k1[j] - k0[j])) * w[j].left;
+				lo += (k0[j + 1] + p * (k1[j + 1] - k0[j + 1])) * w[j + 1].left;
+			}
+			l = le + lo;
+		}
+
+		else
+		{
+			buffer.get (f - 1, w, 4);
+			const float c0 = w[1].left;
+			const float c1 = (w[2].left - w[0].left) * 0.5f;
+			const float c2 = w[0].left - w[1].left * 2.5f + w[2].left * 2.0f - w[3].left * 0.5f;
+			const float c3 = (w[3].left - w[0].left) * 0.5f + (w[1].left - w[2].left) * 1.5f;
+			l = ((c3 * x + c2) * x + c1) * x + c0;
+		}
+
+		return Stereo (l, l);
+	}
+
+	/*
+	 * 4-point, 3rd-order Hermite (x-form) between w[1] and w[2].
+	 */
+	static Stereo hermite (const Stereo* w, const float x)
+	{
+		const Stereo c0 = w[1];
+		const Stereo c1 = (w[2] - w[0]) * 0.5f;
+		const Stereo c2 = w[0] - w[1] * 2.5f + w[2] * 2.0f - w[3] * 0.5f;
+		const Stereo c3 = (w[3] - w[0]) * 0.5f + (w[1] - w[2]) * 1.5f;
+		return ((c3 * x + c2) * x + c1) * x + c0;
+	}
+
+	/*
+	 * RESAMPLER_SINC_TAPS-point windowed sinc between
+	 * w[RESAMPLER_SINC_TAPS / 2 - 1] and w[RESAMPLER_SINC_TAPS / 2].
+	 * Kernel rows of the two nearest phases are linear interpolated. Even
+	 * and odd taps are summed separately.
+	 */
+	static Stereo sinc (const Stereo* w, const float x)
+	{
+		const float* k0;
+		const float* k1;
+		float f;
+		getSincKernels (x, k0, k1, f);
+
+#ifdef RESAMPLER_SSE
+		// Lanes: left even, right even, left odd, right odd
+		const __m128 ff = _mm_set1_ps (f);
+		__m128 acc = _mm_setzero_ps ();
+		for (int j = 0; j < RESAMPLER_SINC_TAPS; j += 4)
+		{
+			const __m128 a = _mm_loadu_ps (k0 + j);
+			const __m128 b = _mm_loadu_ps (k1 + j);
+			const __m128 k = _mm_add_ps (a, _mm_mul_ps (ff, _mm_sub_ps (b, a)));
+			acc = _mm_add_ps (acc, _mm_mul_ps (_mm_unpacklo_ps (k, k), _mm_loadu_ps (&w[j].left)));
+			acc = _mm_add_ps (acc, _mm_mul_ps (_mm_unpackhi_ps (k, k), _mm_loadu_ps (&w[j + 2].left)));
+		}
+		float r[4];
+		_mm_storeu_ps (r, acc);
+		return Stereo (r[0] + r[2], r[1] + r[3]);
+
+#else
+		float le = 0.0f;
+		float re = 0.0f;
+		float lo = 0.0f;
+		float ro = 0.0f;
+		for (int j = 0; j < RESAMPLER_SINC_TAPS; j += 2)
+		{
+			const float ke = k0[j] + f * (k1[j] - k0[j]);
+			const float ko = k0[j + 1] + f * (k1[j + 1] - k0[j + 1]);
+			le += ke * w[j].left;
+			re += ke * w[j].right;
+			lo += ko * w[j + 1].left;
+			ro += ko * w[j + 1].right;
+		}
+		return Stereo (le + lo, re + ro);
+#endif /* RESAMPLER_SSE */
+	}
+
+	/*
+	 * Kernel table with (RESAMPLER_SINC_PHASES + 1) rows of
+	 * RESAMPLER_SINC_TAPS coefficients, each row normalized to unity gain.
+	 * Shared by all instances.
+	 */
+	static const std::vector<float>& getSincTable ()
+	{
+		static const std::vector<float> table = makeSincTable ();
+		return table;
+	}
+
+protected:
+#ifdef RESAMPLER_SSE
+	/*
+	 * hermite () for two frames at once. Lanes: left and right of both
+	 * frames.
+	 */
+	static void hermite2 (const Stereo* w0, const Stereo* w1, const float x0, const float x1, Stereo* dest)
+	{
+		__m128 w[4];
+		for (int j = 0; j < 4; ++j) w[j] = _mm_setr_ps (w0[j].left, w0[j].right, w1[j].left, w1[j].right);
+		const __m128 x = _mm_setr_ps (x0, x0, x1, x1);
+		const __m128 half = _mm_set1_ps (0.5f);
+
+		const __m128 c0 = w[1];
+		const __m128 c1 = _mm_mul_ps (_mm_sub_ps (w[2], w[0]), half);
+		const __m128 c2 = _mm_sub_ps
+		(
+			_mm_add_ps (_mm_sub_ps (w[0], _mm_mul_ps (w[1], _mm_set1_ps (2.5f))), _mm_mul_ps (w[2], _mm_set1_ps (2.0f))),
+			_mm_mul_ps (w[3], half)
+		);
+		const __m128 c3 = _mm_add_ps (_mm_mul_ps (_mm_sub_ps (w[3], w[0]), half), _mm_mul_ps (_mm_sub_ps (w[1], w[2]), _mm_set1_ps (1.5f)));
+		const __m128 r = _mm_add_ps (_mm_mul_ps (_mm_add_ps (_mm_mul_ps (_mm_add_ps (_mm_mul_ps (c3, x), c2), x), c1), x), c0);
+
+		float v[4];
+		_mm_storeu_ps (v, r);
+		dest[0] = Stereo (v[0], v[1]);
+		dest[1] = Stereo (v[2], v[3]);
+	}
+#endif /* RESAMPLER_SSE */
+
+	// Kernel rows next to x and the fraction between them
+	static void getSincKernels (const float x, const float*& k0, const float*& k1, float& fraction)
+	{
+		const std::vector<float>& table = getSincTable ();
+		const float p = x * RESAMPLER_SINC_PHASES;
+		const int i = std::min (int (p), RESAMPLER_SINC_PHASES - 1);	// x may round up to 1.0f
+		fraction = p - i;
+		k0 = &table[i * RESAMPLER_SINC_TAPS];
+		k1 = k0 + RESAMPLER_SINC_TAPS;
+	}
+
+	static std::vector<float> makeSincTable ()
+	{
+		const int half = RESAMPLER_SINC_TAPS / 2;
+		std::vector<float> table ((RESAMPLER_SINC_PHASES + 1) * RESAMPLER_SINC_TAPS, 0.0f);
+		for (int p = 0; p <= RESAMPLER_SINC_PHASES; ++p)
+		{
+			const double x = double (p) / RESAMPLER_SINC_PHASES;
+			double sum = 0.0;
+			for (int j = 0; j < RESAMPLER_SINC_TAPS; ++j)
+			{
+				const double t = double (j - (half - 1)) - x;	// Distance to the read position
+				const double s = (t == 0.0 ? 1.0 : sin (M_PI * t) / (M_PI * t));
+				const double n = (t + half) / RESAMPLER_SINC_TAPS;	// Window position 0..1
+				const double win = 0.42 - 0.5 * cos (2.0 * M_PI * n) + 0.08 * cos (4.0 * M_PI * n);
+				table[p * RESAMPLER_SINC_TAPS + j] = s * win;
+				sum += s * win;
+			}
+			for (int j = 0; j < RESAMPLER_SINC_TAPS; ++j) table[p * RESAMPLER_SINC_TAPS + j] /= sum;
+		}
+		return table;
+	}
+};
+
+#endif /* RESAMPLER_HPP_ */
@@ -40,6 +40,7 @@ public:
         RingBuffer& operator= (const RingBuffer& that);
         T& operator[] (const long n);
         const T& operator[] (const long n) const;
+        void get (const long n, T* dest, const size_t count) const;
         T& front ();
         const T& front () const;
         size_t size () const;
@@ -95,6 +96,17 @@ template <class T> inline const T& RingBuffer<T>::operator[] (const long n) cons
 
 template <class T> inline T& RingBuffer<T>::operator[] (const long n) {return data_[(position_ + n) % size_];}
 
+template <class T> inline void RingBuffer<T>::get (const long n, T* dest, const size_t count) const
+{
+        // Copy count elements starting at n with a single modulo
+        size_t p = (position_ + n) % size_;
+        for (size_t i = 0; i < count; ++i)
+        {
+                dest[i] = data_[p];
+                if (++p == size_) p = 0;
+        }
+}
+
 template <class T> inline const T& RingBuffer<T>::front () const {return data_[position_];}
 
 template <class T> inline T& RingBuffer<T>::front () {return data_[position_];}
@@ -20,13 +20,15 @@
 
 #include "SampleChooser.hpp"
 #include <new>
+#include <cstdint>
+#include <system_error>
 
 #ifndef SF_FORMAT_MP3
 #ifndef MINIMP3_IMPLEMENTATION
 #define MINIMP3_IMPLEMENTATION
 #endif
 #endif
-#include "Sample.hpp"
+#include "PeakLoader.hpp"
 
 SampleChooser::SampleChooser () : SampleChooser (0.0, 0.0, 0.0, 0.0, "FileChooser") {}
 
@@ -58,7 +60,10 @@ SampleChooser::SampleChooser (const double x, const double y, const double width
 	loopCheckbox (0, 0, 0, 0, name + "/checkbox"),
 	loopLabel (0, 0, 0, 0, name + "/label"),
 	noFileLabel (0, 0, 0, 0, name + "/label"),
-	sample (nullptr)
+	samplePath (), peaks (), peakLoader (), peakVersion (0), peakThreads (),
+	sampleStart (0), sampleEnd (INT64_MAX),
+	detail (), detailStart (0), detailCount (0), detailBins (0),
+	detailReader (), detailLoader (), detailThreads ()
 {
 	std::vector<std::string> sampleLabels = {"Play selection as loop", "File", "Selection start", "Selection end", "frames", "No audio file selected"};
 	labels.insert (labels.end(), sampleLabels.begin(), sampleLabels.end());
@@ -94,10 +99,13 @@ SampleChooser::SampleChooser (const SampleChooser& that) :
 	startMarker (that.startMarker), endMarker (that.endMarker),
 	sizeLabel (that.sizeLabel), startLabel (that.startLabel), endLabel (that.endLabel),
 	loopCheckbox (that.loopCheckbox), loopLabel (that.loopLabel), noFileLabel (that.noFileLabel),
-	sample (nullptr)
+	samplePath (that.samplePath), peaks (that.peaks), peakLoader (), peakVersion (0), peakThreads (),
+	sampleStart (that.sampleStart), sampleEnd (that.sampleEnd),
+	detail (), detailStart (0), detailCount (0), detailBins (0),
+	detailReader (), detailLoader (), detailThreads ()
 {
-	try {sample = new Sample (*that.sample);}
-	catch (std::exception& exc) {throw exc;}
+	// Peaks are shared, pending loads restart
+	if (that.peakLoader) loadPeaks ();
 
 	add (waveform);
 	waveform.add (startMarker);
@@ -113,7 +121,8 @@ SampleChooser::SampleChooser (const SampleChooser& that) :
 
 SampleChooser::~SampleChooser()
 {
-	if (sample) delete (sample);
+	cancelPeaks ();
+	joinPeakThreads (true);
 }
 
 SampleChooser& SampleChooser::operator= (const SampleChooser& that)
@@ -128,7 +137,7 @@ SampleChooser& SampleChooser::operator= (const SampleChooser& that)
 	release (&loopCheckbox);
 	release (&loopLabel);
 	release (&noFileLabel);
-	if (sample) delete (sample);
+	cancelPeaks ();
 
 	waveform = that.waveform;
 	scrollbar = that.scrollbar;
@@ -140,9 +149,15 @@ SampleChooser& SampleChooser::operator= (const SampleChooser& that)
 	loopCheckbox = that.loopCheckbox;
 	loopLabel = that.loopLabel;
 	noFileLabel = that.noFileLabel;
-	try {sample = new Sample (*that.sample);}
-	catch (std::exception& exc) {throw exc;}
+	samplePath = that.samplePath;
+	peaks = that.peaks;
+	sampleStart = that.sampleStart;
+	sampleEnd = that.sampleEnd;
+	detail.clear ();
+	detailCount = 0;
+	detailBins = 0;
 	FileChooser::operator= (that);
+	if (that.peakLoader) loadPeaks ();
 
 	add (waveform);
 	waveform.add (startMarker);
@@ -169,28 +184,20 @@ void SampleChooser::setFileName (const std::string& filename)
 		std::string newPath = getPath() + "/" + filename;
 		char buf[PATH_MAX];
 		char *rp = realpath(newPath.c_str(), buf);
-		if (sample)
-		{
-			delete (sample);
-			sample = nullptr;
-		}
-		try {sample = new Sample (rp);}
-		catch (std::exception& exc)
-		{
-			std::cerr << exc.what() << "\n";
-			noFileLabel.setText (exc.what());
-		}
-
-		if (sample)
-		{
-			noFileLabel.setText (labels[BWIDGETS_DEFAULT_SAMPLECHOOSER_NO_FILE_INDEX]);
-
-			sample->start = 0;
-			sample->end = sample->info.frames;
-
-			scrollbar.minButton.setValue (0.0);
-			scrollbar.maxButton.setValue (1.0);
-		}
+		cancelPeaks ();
+		peaks.reset ();
+		detail.clear ();
+		detailCount = 0;
+		detailBins = 0;
+		samplePath = (rp ? rp : "");
+		sampleStart = 0;
+		sampleEnd = INT64_MAX;
+		noFileLabel.setText (labels[BWIDGETS_DEFAULT_SAMPLECHOOSER_NO_FILE_INDEX]);
+		scrollbar.minButton.setValue (0.0);
+		scrollbar.maxButton.setValue (1.0);
+
+		// Only the peaks are needed for preview and range selection
+		if (samplePath != "") loadPeaks ();
 
 		update();
 	}
@@ -198,21 +205,23 @@ void SampleChooser::setFileName (const std::string& filename)
 
 void SampleChooser::setStart (const int64_t start)
 {
-	if (!sample) return;
-	sample->start = LIMIT (start, 0, sample->info.frames - 1);
+	if (samplePath == "") return;
+
+	// Limit now if the sample header is already known, otherwise on loading
+	sampleStart = (hasSample() ? LIMIT (start, 0, getFrames() - 1) : start);
 	update();
 }
 
-int64_t SampleChooser::getStart() const {return (sample ? LIMIT (sample->start, 0, sample->info.frames - 1) : 0);}
+int64_t SampleChooser::getStart() const {return (hasSample() ? LIMIT (sampleStart, 0, getFrames() - 1) : 0);}
 
 void SampleChooser::setEnd (const int64_t end)
 {
-	if (!sample) return;
-	sample->end = LIMIT (end, 0, sample->info.frames);
+	if (samplePath == "") return;
+	sampleEnd = (hasSample() ? LIMIT (end, 0, getFrames()) : end);
 	update();
 }
 
-int64_t SampleChooser::getEnd() const {return (sample ? LIMIT (sample->end, 1, sample->info.frames) : 0);}
+int64_t SampleChooser::getEnd() const {return (hasSample() ? LIMIT (sampleEnd, 1, getFrames()) : 0);}
 
 void SampleChooser::setLoop (const bool loop) {loopCheckbox.setValue (loop ? 1.0 : 0.0);}
 
@@ -296,7 +305,7 @@ void SampleChooser::update ()
 
 			double waveformHeight = fileListBoxHeight;
 
-			if (sample && (sample->info.frames > 0))
+			if (hasSample())
 			{
 				sizeLabel.resize();
 				const double sizeHeight = sizeLabel.getHeight();
@@ -351,7 +360,7 @@ void SampleChooser::update ()
 
 			scrollbar.moveTo (x0 + 0.4 * w + 5, y0 + pathNameHeight + 20 + waveformHeight - 12);
 			scrollbar.resize (0.6 * w - 15, 10);
-			if (sample && (sample->info.frames > 0))
+			if (hasSample())
 			{
 				startMarker.show();
 				endMarker.show();
@@ -476,11 +485,9 @@ void SampleChooser::sfileListBoxClickedCallback (BEvents::Event* event)
 		if (val <= fc->dirs.size())
 		{
 			fc->fileNameBox.setText ("");
-			if (fc->sample)
-			{
-				delete (fc->sample);
-				fc->sample = nullptr;
-			}
+			fc->cancelPeaks ();
+			fc->peaks.reset ();
+			fc->samplePath = "";
 			BEvents::ValueChangedEvent dummyEvent = BEvents::ValueChangedEvent (&fc->okButton, 1.0);
 			fc->noFileLabel.setText (fc->labels[BWIDGETS_DEFAULT_SAMPLECHOOSER_NO_FILE_INDEX]);
 			fc->okButtonClickedCallback (&dummyEvent);
@@ -522,17 +529,18 @@ void SampleChooser::lineDraggedCallback (BEvents::Event* event)
 	BWidgets::DrawingSurface* ds = (BWidgets::DrawingSurface*)w->getParent();
 	if (!ds) return;
 	SampleChooser* fc = (SampleChooser*)ds->getParent();
-	if ((!fc) || (!fc->sample) || (fc->sample->info.frames == 0) || (fc->waveform.getEffectiveWidth() <= 0.0)) return;
+	if ((!fc) || (!fc->hasSample()) || (fc->waveform.getEffectiveWidth() <= 0.0)) return;
 
+	const int64_t frames = fc->getFrames();
 	const double start = fc->scrollbar.minButton.getValue();
 	const double range = fc->scrollbar.maxButton.getValue() - start;
 	const double dp = pev->getDelta().x / fc->waveform.getEffectiveWidth();
-	const double df = dp * range * double (fc->sample->info.frames);
+	const double df = dp * range * double (frames);
 
-	if (w == &fc->startMarker) fc->sample->start = LIMIT (fc->sample->start + df, 0, fc->sample->info.frames - 1);
-	else if (w == &fc->endMarker) fc->sample->end = LIMIT (fc->sample->end + df, 1, fc->sample->info.frames);
+	if (w == &fc->startMarker) fc->sampleStart = LIMIT (fc->sampleStart + df, 0, frames - 1);
+	else if (w == &fc->endMarker) fc->sampleEnd = LIMIT (fc->sampleEnd + df, 1, frames);
 
-	if (fc->sample->start >= fc->sample->end) fc->sample->start = fc->sample->end - 1;
+	if (fc->sampleStart >= fc->sampleEnd) fc->sampleStart = fc->sampleEnd - 1;
 	fc->drawWaveform();
 }
 
@@ -560,51 +568,53 @@ void SampleChooser::drawWaveform()
 	cairo_t* cr = cairo_create (waveform.getDrawingSurface ());
 	if (cr && cairo_status (cr) == CAIRO_STATUS_SUCCESS)
 	{
-		if (sample && (sample->info.frames) && (sample->info.samplerate) && (w >= 1.0))
+		if (hasSample() && (peaks->samplerate) && (w >= 1.0))
 		{
-			// Scan for min/max
+			const int64_t frames = peaks->frames;
+			const int rate = peaks->samplerate;
+			const int64_t s0 = getStart();
+			const int64_t s1 = getEnd();
 			const double start = scrollbar.minButton.getValue();
 			const double range = scrollbar.maxButton.getValue() - start;
-			double max = 1.0;
-			for (double i = 0.0; i < 1.0; i += 0.25 / w)
+			const double max = std::max (1.0, double (peaks->getMaxAbs()));
+
+			// One min / max line per half unit
+			const int nrColumns = ceil (2.0 * w);
+			const double columnFrames = range * double (frames) / nrColumns;
+			const int64_t f0 = floor (start * double (frames));
+
+			// Zoomed in below the peak resolution: decode the visible range in
+			// the background and use the peaks until done
+			bool useDetail = false;
+			if ((columnFrames < PEAKDATA_BINSIZE) && (range > 0.0))
 			{
-				if (fabs (sample->get (i * double (sample->info.frames), 0, sample->info.samplerate)) > max)
-				{
-					max = fabs (sample->get (i * double (sample->info.frames), 0, sample->info.samplerate));
-				}
+				const int64_t count = ceil (range * double (frames));
+				if ((detailStart == f0) && (detailCount == count) && (detailBins == nrColumns)) useDetail = (int (detail.size()) == nrColumns);
+				else loadDetail (f0, count, nrColumns);
 			}
 
-			cairo_set_line_width (cr, 0.1);
-			double lo = sample->get (start * double (sample->info.frames), 0, sample->info.samplerate);
-			double hi = lo;
-			const double step = 0.1 / w;
-			const double minstep = LIMIT (1.0 / (range * double (sample->info.frames)), 0.01 * step, step);
-			for (double x = 0; x < 1.0; x += step)
+			if (!peaks->levels.empty())
 			{
-				double s = 0;
-				for (double xm = 0; xm < step; xm += minstep)
+				cairo_set_line_width (cr, 0.5);
+				for (int i = 0; i < nrColumns; ++i)
 				{
-					const double f = (start + (x + xm) * range) * double (sample->info.frames);
-					s = sample->get (f, 0, sample->info.samplerate);
-					if (s > hi) hi = s;
-					if (s < lo) lo = s;
+					const double fa = (start * double (frames)) + i * columnFrames;
+					const PeakBin bin = (useDetail ? detail[i] : peaks->get (fa, fa + columnFrames));
+					const double x = x0 + (i + 0.5) * w / nrColumns;
+					if ((fa >= s0) && (fa <= s1)) cairo_set_source_rgba (cr, 1.0, 1.0, 1.0, 1.0);
+					else cairo_set_source_rgba (cr, 0.25, 0.25, 0.25, 1.0);
+					cairo_move_to (cr, x, y0 + 0.5 * h - 0.5 * h * bin.min / max);
+					cairo_line_to (cr, x, y0 + 0.5 * h - 0.5 * h * bin.max / max - 1.0);
+					cairo_stroke (cr);
 				}
-				const double frame = (start + x * range) * double (sample->info.frames);
-				if ((frame >= sample->start) && (frame <= sample->end)) cairo_set_source_rgba (cr, 1.0, 1.0, 1.0, 1.0);
-				else cairo_set_source_rgba (cr, 0.25, 0.25, 0.25, 1.0);
-				cairo_move_to (cr, x0 + x * w, y0 + 0.5 * h - 0.5 * h * lo / max);
-				cairo_line_to (cr, x0 + x * w, y0 + 0.5 * h - 0.5 * h * hi / max);
-				cairo_stroke (cr);
-				lo = s;
-				hi = s + 2.0 * max / h;
 			}
 
 			// Set start and end line
 			if (range > 0)
 			{
-				const double sp = (sample->start / double (sample->info.frames) - start) / range;
+				const double sp = (s0 / double (frames) - start) / range;
 				startMarker.moveTo (x0 + sp * w - 0.5 * startMarker.getWidth(), 0.0);
-				const double ep = (sample->end / double (sample->info.frames) - start) / range;
+				const double ep = (s1 / double (frames) - start) / range;
 				endMarker.moveTo (x0 + ep * w - 0.5 * endMarker.getWidth(), 0.0);
 			}
 
@@ -618,36 +628,36 @@ void SampleChooser::drawWaveform()
 			sizeLabel.setText
 			(
 				labels[BWIDGETS_DEFAULT_SAMPLECHOOSER_FILE_INDEX] + ": " +
-				std::to_string (int (sample->info.frames / (sample->info.samplerate * 60))) +
+				std::to_string (int (frames / (rate * 60))) +
 				":" +
-				std::to_string ((int (sample->info.frames / sample->info.samplerate) % 60) / 10) +
-				std::to_string ((int (sample->info.frames / sample->info.samplerate) % 60) % 10) +
+				std::to_string ((int (frames / rate) % 60) / 10) +
+				std::to_string ((int (frames / rate) % 60) % 10) +
 				" (" +
-				std::to_string (sample->info.frames) +
+				std::to_string (frames) +
 				") " +
 				labels[BWIDGETS_DEFAULT_SAMPLECHOOSER_FRAMES_INDEX]
 			);
 			startLabel.setText
 			(
 				labels[BWIDGETS_DEFAULT_SAMPLECHOOSER_SELECTION_START_INDEX] + ": " +
-				std::to_string (int (sample->start / (sample->info.samplerate * 60))) +
+				std::to_string (int (s0 / (rate * 60))) +
 				":" +
-				std::to_string ((int (sample->start / sample->info.samplerate) % 60) / 10) +
-				std::to_string ((int (sample->start / sample->info.samplerate) % 60) % 10) +
+				std::to_string ((int (s0 / rate) % 60) / 10) +
+				std::to_string ((int (s0 / rate) % 60) % 10) +
 				" (" +
-				std::to_string (sample->start) +
+				std::to_string (s0) +
 				") " +
 				labels[BWIDGETS_DEFAULT_SAMPLECHOOSER_FRAMES_INDEX]
 			);
 			endLabel.setText
 			(
 				labels[BWIDGETS_DEFAULT_SAMPLECHOOSER_SELECTION_END_INDEX] + ": " +
-				std::to_string (int (sample->end / (sample->info.samplerate * 60))) +
+				std::to_string (int (s1 / (rate * 60))) +
 				":" +
-				std::to_string ((int (sample->end / sample->info.samplerate) % 60) / 10) +
-				std::to_string ((int (sample->end / sample->info.samplerate) % 60) % 10) +
+				std::to_string ((int (s1 / rate) % 60) / 10) +
+				std::to_string ((int (s1 / rate) % 60) % 10) +
 				" (" +
-				std::to_string (sample->end) +
+				std::to_string (s1) +
 				") " +
 				labels[BWIDGETS_DEFAULT_SAMPLECHOOSER_FRAMES_INDEX]
 			);
@@ -665,6 +675,154 @@ void SampleChooser::drawWaveform()
 	waveform.update ();
 }
 
+bool SampleChooser::hasSample () const {return (peaks && (peaks->frames > 0));}
+
+int64_t SampleChooser::getFrames () const {return (peaks ? peaks->frames : 0);}
+
+void SampleChooser::loadPeaks ()
+{
+	cancelPeaks ();
+	joinPeakThreads (false);
+
+	// Cached peaks are shown immediately
+	std::shared_ptr<const PeakData> cached = PeakLoader::getCached (samplePath);
+	if (cached)
+	{
+		peaks = cached;
+		return;
+	}
+
+	peakLoader = std::make_shared<PeakLoader> (samplePath);
+	peakVersion = 0;
+	try {peakThreads.push_back (std::make_pair (std::thread (PeakLoader::run, peakLoader), peakLoader));}
+	catch (const std::system_error& err)
+	{
+		// No thread? Load synchronously
+		PeakLoader::run (peakLoader);
+	}
+
+	updateIdle ();
+}
+
+void SampleChooser::cancelPeaks ()
+{
+	if (peakLoader)
+	{
+		peakLoader->cancelled = true;
+		peakLoader.reset ();
+	}
+
+	// Running detail reads finish on their own reader
+	detailLoader.reset ();
+	detailReader.reset ();
+	updateIdle ();
+}
+
+void SampleChooser::loadDetail (const int64_t start, const int64_t count, const int nrBins)
+{
+	// One read at a time. update () requests again once done.
+	if (detailLoader) return;
+
+	if (!detailReader) detailReader = std::make_shared<SampleReader> (samplePath);
+	detailLoader = std::make_shared<DetailLoader> (detailReader, start, count, nrBins);
+	try {detailThreads.push_back (std::make_pair (std::thread (DetailLoader::run, detailLoader), detailLoader));}
+	catch (const std::system_error& err)
+	{
+		// No thread? Load synchronously
+		DetailLoader::run (detailLoader);
+	}
+
+	updateIdle ();
+}
+
+template <class Loader>
+static void joinThreads (std::vector<std::pair<std::thread, std::shared_ptr<Loader>>>& threads, const bool all)
+{
+	for (typename std::vector<std::pair<std::thread, std::shared_ptr<Loader>>>::iterator it = threads.begin(); it != threads.end(); )
+	{
+		if (all || it->second->done)
+		{
+			if (it->first.joinable ()) it->first.join ();
+			it = threads.erase (it);
+		}
+		else ++it;
+	}
+}
+
+void SampleChooser::joinPeakThreads (const bool all)
+{
+	joinThreads (peakThreads, all);
+	joinThreads (detailThreads, all);
+}
+
+void SampleChooser::updateIdle () {setIdle ((dirScan != nullptr) || (peakLoader != nullptr) || (detailLoader != nullptr));}
+
+void SampleChooser::onIdle ()
+{
+	FileChooser::onIdle ();
+	joinPeakThreads (false);
+
+	if (detailLoader && detailLoader->done)
+	{
+		// Failed reads are stored too (empty detail) to not retry each update
+		detail = detailLoader->bins;
+		detailStart = detailLoader->start;
+		detailCount = detailLoader->count;
+		detailBins = detailLoader->nrBins;
+		detailLoader.reset ();
+		updateIdle ();
+		update ();
+	}
+
+	if (!peakLoader)
+	{
+		updateIdle ();
+		return;
+	}
+
+	std::shared_ptr<const PeakData> newPeaks;
+	std::string error;
+	bool changed = false;
+	bool finished = false;
+	{
+		std::lock_guard<std::mutex> lock (peakLoader->mutex);
+		if (peakLoader->version != peakVersion)
+		{
+			newPeaks = peakLoader->data;
+			error = peakLoader->error;
+			peakVersion = peakLoader->version;
+			changed = true;
+		}
+		finished = peakLoader->finished;
+	}
+
+	if (finished)
+	{
+		peakLoader.reset ();
+		updateIdle ();
+	}
+
+	if (changed)
+	{
+		const bool hadSample = hasSample ();
+		peaks = newPeaks;
+		if (error != "")
+		{
+			std::cerr << error << "\n";
+			noFileLabel.setText (error);
+		}
+
+		// Apply selection set before the sample header was known
+		if (hasSample () && (!hadSample))
+		{
+			sampleStart = LIMIT (sampleStart, 0, peaks->frames - 1);
+			sampleEnd = LIMIT (sampleEnd, 0, peaks->frames);
+		}
+
+		update ();
+	}
+}
+
 std::function<void (BEvents::Event*)> SampleChooser::getFileListBoxClickedCallback()
 {
 	return sfileListBoxClickedCallback;
@@ -26,6 +26,9 @@
 #include "HRangeScrollbar.hpp"
 #include "VLine.hpp"
 #include "Checkbox.hpp"
+#include "PeakData.hpp"
+#include <memory>
+#include <thread>
 #define BWIDGETS_DEFAULT_SAMPLECHOOSER_WIDTH 800
 #define BWIDGETS_DEFAULT_SAMPLECHOOSER_HEIGHT 320
 #define BWIDGETS_DEFAULT_SAMPLECHOOSER_FILTERS std::regex (".*\\.((wav)|(wave)|(aif)|(aiff)|(au)|(sd2)|(flac)|(caf)|(ogg)|(mp3))$", std::regex_constants::icase)
@@ -36,7 +39,9 @@
 #define BWIDGETS_DEFAULT_SAMPLECHOOSER_FRAMES_INDEX 11
 #define BWIDGETS_DEFAULT_SAMPLECHOOSER_NO_FILE_INDEX 12
 
-class Sample;	// Forward declaration
+struct PeakLoader;	// Forward declarations
+class SampleReader;
+struct DetailLoader;
 
 class SampleChooser : public BWidgets::FileChooser
 {
@@ -71,6 +76,7 @@ public:
 	virtual void update () override;
 	virtual void applyTheme (BStyles::Theme& theme) override;
 	virtual void applyTheme (BStyles::Theme& theme, const std::string& name) override;
+	virtual void onIdle () override;
 	static void sfileListBoxClickedCallback (BEvents::Event* event);
 	static void scrollbarChangedCallback (BEvents::Event* event);
 	static void lineDraggedCallback (BEvents::Event* event);
@@ -88,8 +94,28 @@ protected:
 	BWidgets::Label loopLabel;
 	BWidgets::Label noFileLabel;
 
-	Sample* sample;
+	std::string samplePath;
+	std::shared_ptr<const PeakData> peaks;
+	std::shared_ptr<PeakLoader> peakLoader;
+	unsigned int peakVersion;
+	std::vector<std::pair<std::thread, std::shared_ptr<PeakLoader>>> peakThreads;
+	int64_t sampleStart;
+	int64_t sampleEnd;
+	std::vector<PeakBin> detail;
+	int64_t detailStart;
+	int64_t detailCount;
+	int detailBins;
+	std::shared_ptr<SampleReader> detailReader;
+	std::shared_ptr<DetailLoader> detailLoader;
+	std::vector<std::pair<std::thread, std::shared_ptr<DetailLoader>>> detailThreads;
 
+	bool hasSample () const;
+	int64_t getFrames () const;
+	void loadPeaks ();
+	void cancelPeaks ();
+	void loadDetail (const int64_t start, const int64_t count, const int nrBins);
+	void joinPeakThreads (const bool all);
+	virtual void updateIdle () override;
 	void drawWaveform();
 	virtual std::function<void (BEvents::Event*)> getFileListBoxClickedCallback() override;
 };
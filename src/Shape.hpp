@@ -40,8 +40,8 @@ public:
 	Shape (const StaticArrayList<Node, sz> nodes, double transformFactor = 1.0, double transformOffset = 0.0);
 	virtual ~Shape ();
 
-	bool operator== (const Shape<sz>& rhs);
-	bool operator!= (const Shape<sz>& rhs);
+	bool operator== (const Shape<sz>& rhs) const;
+	bool operator!= (const Shape<sz>& rhs) const;
 
 	void setTransformation (const double transformFactor, const double transformOffset);
 	virtual void clearShape ();
@@ -92,14 +92,14 @@ nodes_ (nodes), map_ {0.0}, factor_ (transformFactor), offset_ (transformFactor)
 
 template<size_t sz> Shape<sz>::~Shape () {}
 
-template<size_t sz> bool Shape<sz>::operator== (const Shape<sz>& rhs)
+template<size_t sz> bool Shape<sz>::operator== (const Shape<sz>& rhs) const
 {
 	if (size () != rhs.size ()) return false;
 	for (unsigned int i = 0; i < size (); ++i) if (nodes_[i] != rhs.nodes_[i]) return false;
 	return true;
 }
 
-template<size_t sz> bool Shape<sz>::operator!= (const Shape<sz>& rhs) {return !(*this == rhs);}
+template<size_t sz> bool Shape<sz>::operator!= (const Shape<sz>& rhs) const {return !(*this == rhs);}
 
 template<size_t sz> void Shape<sz>::setTransformation (const double transformFactor, const double transformOffset)
 {
@@ -62,6 +62,7 @@ Slot::Slot () : Slot (nullptr, FX_INVALID, nullptr, nullptr, 0, 0.0f, 0.0) {}
 Slot::Slot (BOops* plugin, const BOopsEffectsIndex effect, float* params, Pad* pads, const size_t size, const float mixf, const double framesPerStep) :
 	plugin (plugin), effect (FX_INVALID), midis (), slotShape(), slotKeys(), slotMode (MODE_PATTERN),
 	initPos (0.0), lastPos (0.0), patchPos (0.0), shapePaused (true),
+	silentInput (0), quietInput (0), silentOutput (0), monoInput (0),
 	fx (nullptr),
 	size (size), mixf (mixf), framesPerStep (framesPerStep), buffer (nullptr), shape ()
 {
@@ -90,6 +91,10 @@ Slot:: Slot (const Slot& that) :
 	slotMode (that.slotMode),
 	initPos (that.initPos),
 	lastPos (that.lastPos),
+	silentInput (that.silentInput),
+	quietInput (that.quietInput),
+	silentOutput (0),
+	monoInput (that.monoInput),
 	fx (nullptr),
 	size (that.size), 
 	mixf (that.mixf),
@@ -122,6 +127,10 @@ Slot& Slot::operator= (const Slot& that)
 	initPos = that.initPos;
 	lastPos = that.lastPos;
 	patchPos = that.patchPos;
+	silentInput = that.silentInput;
+	quietInput = that.quietInput;
+	silentOutput = 0;
+	monoInput = that.monoInput;
 	size = that.size;
 	mixf = that.mixf;
 	framesPerStep = that.framesPerStep;
@@ -270,7 +279,12 @@ Fx* Slot::newFx (const BOopsEffectsIndex effect)
 		default: 			fx = new Fx (&buffer, params, pads);
 	}
 
-	if (fx != 0) fx->init (0.0);
+	if (fx != 0)
+	{
+		if (plugin) fx->seed (plugin->nextSeed ());
+		fx->setQuality (plugin ? plugin->getInterpolation () : RESAMPLER_DEFAULT_QUALITY);
+		fx->init (0.0);
+	}
 
 	return fx;
 }
@@ -281,9 +295,38 @@ void Slot::init (const double position)
 	lastPos = position;
 	patchPos = 0.0;
 	shapePaused = true;
+	silentOutput = 0;
 	if (fx) fx->init (position);
 }
 
+static bool isQuiet (const Stereo& s)
+{
+	return ((fabsf (s.left) < SLOT_SILENCE_THRESHOLD) && (fabsf (s.right) < SLOT_SILENCE_THRESHOLD));
+}
+
+void Slot::push (const Stereo& input)
+{
+	buffer->push_front (input);
+	silentInput = ((input.left == 0.0f) && (input.right == 0.0f) ? silentInput + 1 : 0);
+	quietInput = (isQuiet (input) ? quietInput + 1 : 0);
+	monoInput = (input.left == input.right ? monoInput + 1 : 0);
+}
+
+bool Slot::isIdle () const
+{
+	const long tail = fx->getTail ();
+	if (tail == FX_TAIL_INFINITE) return false;
+	if (tail == FX_TAIL_DECAY)
+	{
+		const long frames = SLOT_SILENCE_DECAYTIME * (plugin ? plugin->host.rate : 48000);
+		return ((quietInput > frames) && (silentOutput > frames));
+	}
+
+	// Only digital silence: effects with gain (distortion, width) amplify
+	// signals below SLOT_SILENCE_THRESHOLD to audible levels
+	return (silentInput > tail);
+}
+
 void Slot::end ()
 {
 	shapePaused = true;
@@ -356,11 +399,15 @@ Stereo Slot::play (const double position)
 	if (!params[SLOTS_PLAY]) return (*buffer).front();
 	if (!fx->isPlaying()) return (*buffer).front();
 	if (!isPadSet(position)) return (*buffer).front();
+	if (isIdle ()) return (*buffer).front();
 
 	const int index = startPos[int(position)];
 	const double relpos = position - double (index);
 	const Stereo s0 = (*buffer).front();
+	fx->setMono (monoInput);
 	const Stereo s1 = fx->playPad (relpos, pads[index].size, pads[index].mix);
+	silentOutput = (isQuiet (fx->getWet ()) ? silentOutput + 1 : 0);
+	if ((*buffer).front().left != (*buffer).front().right) monoInput = 0;	// Written back by fx (feedback)
 	return BUtilities::mix<Stereo> (s0, s1, mixf);
 }
 
@@ -380,7 +427,91 @@ Stereo Slot::play (const double position, const float mx)
 	if ((position < lastPos) && (position < 1.0)) patchPos += std::ceil (lastPos);
 	lastPos = position;
 
+	if (isIdle ()) return (*buffer).front();
+
 	const Stereo s0 = (*buffer).front();
+	fx->setMono (monoInput);
 	const Stereo s1 = fx->play (std::max (position - initPos + patchPos, 0.0), size, mx, mixf);
+	silentOutput = (isQuiet (fx->getWet ()) ? silentOutput + 1 : 0);
+	if ((*buffer).front().left != (*buffer).front().right) monoInput = 0;	// Written back by fx (feedback)
 	return BUtilities::mix<Stereo> (s0, s1, mixf);
 }
+
+void Slot::play (const double* positions, Stereo* frames, const int n)
+{
+	double relpos[BOOPS_BLOCKSIZE];
+	double delays[BOOPS_BLOCKSIZE];
+	Stereo output[BOOPS_BLOCKSIZE];
+
+	int i = 0;
+	while (i < n)
+	{
+		// Block processing for buffer-reading effects in pattern mode, as
+		// long as the same pad is played
+		int count = 1;
+		const int index = (isPadSet (positions[i]) ? startPos[int (positions[i])] : -1);
+		if
+		(
+			(slotMode == MODE_PATTERN) && fx && buffer && params[SLOTS_PLAY] && (mixf == 1.0f) &&
+			(index >= 0) && fx->isPlaying() && (fx->getTail () == FX_TAIL_INFINITE)
+		)
+		{
+			while
+			(
+				(i + count < n) && (count < BOOPS_BLOCKSIZE) &&
+				isPadSet (positions[i + count]) && (startPos[int (positions[i + count])] == index)
+			) ++count;
+
+			for (int j = 0; j < count; ++j) relpos[j] = positions[i + j] - double (index);
+		}
+
+		if ((count < 2) || (!fx->getFrames (relpos, count, delays)))
+		{
+			for (int j = i; j < i + count; ++j)
+			{
+				push (frames[j]);
+				frames[j] = play (positions[j]);
+			}
+			i += count;
+			continue;
+		}
+
+		// Delays refer to the buffer front at the time of each frame. Shift
+		// them to the front after pushing all frames if the buffer is large
+		// enough and if no frame reads within the RESAMPLER_SINC_TAPS / 2 - 1
+		// newest frames (interpolation kernels mustn't see frames pushed
+		// later). Otherwise push and read frame by frame.
+		const Stereo* input = frames + i;
+		bool shift = true;
+		for (int j = 0; j < count; ++j)
+		{
+			if
+			(
+				(delays[j] < RESAMPLER_SINC_TAPS / 2 - 1) ||
+				(delays[j] + double (count - 1 - j + RESAMPLER_SINC_TAPS) >= double (buffer->size ()))
+			) shift = false;
+		}
+
+		if (shift)
+		{
+			for (int j = 0; j < count; ++j)
+			{
+				push (input[j]);
+				delays[j] += double (count - 1 - j);
+			}
+			fx->playPadFrames (relpos, delays, count, pads[index].size, pads[index].mix, input, output);
+		}
+
+		else
+		{
+			for (int j = 0; j < count; ++j)
+			{
+				push (input[j]);
+				fx->playPadFrames (relpos + j, delays + j, 1, pads[index].size, pads[index].mix, input + j, output + j);
+			}
+		}
+
+		for (int j = 0; j < count; ++j) frames[i + j] = BUtilities::mix<Stereo> (input[j], output[j], mixf);
+		i += count;
+	}
+}
@@ -32,6 +32,9 @@
 #include "MidiKey.hpp"
 #include "StaticArrayList.hpp"
 
+#define SLOT_SILENCE_THRESHOLD 0.000001f
+#define SLOT_SILENCE_DECAYTIME 1.0
+
 enum SlotMode
 {
 	MODE_PATTERN	= 0,
@@ -65,8 +68,10 @@ public:
 	int getStartPad (const int index) const;
 	bool isPadSet (const int index) const {return ((startPos[index] >= 0) && (startPos[index] + pads[startPos[index]].size > index));}
 	void init (const double position);
+	void push (const Stereo& input);
 	Stereo play (const double position);
 	Stereo play (const double position, const float mx);
+	void play (const double* positions, Stereo* frames, const int n);
 	void end ();
 
 	BOops* plugin;
@@ -75,6 +80,7 @@ public:
 	StaticArrayList<MidiKey, 16> midis;
 protected:
 	float adsr (const double position, const double size) const;
+	bool isIdle () const;
 	Pad pads[NR_STEPS];
 	Shape<SHAPE_MAXNODES> slotShape;
 	std::array<bool, NR_PIANO_KEYS + 1> slotKeys;
@@ -83,6 +89,10 @@ protected:
 	double lastPos;		// Shape / keys mode
 	double patchPos;	// Shape / keys mode
 	bool shapePaused;	// Shape / keys mode
+	long silentInput;	// Frames of digital silence pushed to buffer
+	long quietInput;	// Frames below SLOT_SILENCE_THRESHOLD pushed to buffer
+	long silentOutput;	// Frames of silent fx output (before mix)
+	long monoInput;		// Frames with identical channels pushed to buffer
 
 public:
 	int startPos[NR_STEPS];
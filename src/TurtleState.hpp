@@ -0,0 +1,359 @@
+/* B.Oops
+ * Glitch effect sequencer LV2 plugin
+ *
+ * Copyright (C) 2020 by Sven Jähnichen
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef TURTLESTATE_HPP_
+#define TURTLESTATE_HPP_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cctype>
+#include <cstdlib>
+
+#define TURTLE_LV2_PORT "http://lv2plug.in/ns/lv2core#port"
+#define TURTLE_LV2_SYMBOL "http://lv2plug.in/ns/lv2core#symbol"
+#define TURTLE_PSET_VALUE "http://lv2plug.in/ns/ext/presets#value"
+#define TURTLE_STATE_STATE "http://lv2plug.in/ns/ext/state#state"
+#define TURTLE_RDF_TYPE "http://www.w3.org/1999/02/22-rdf-syntax-ns#type"
+#define TURTLE_RDF_VALUE "http://www.w3.org/1999/02/22-rdf-syntax-ns#value"
+#define TURTLE_XSD_PREFIX "http://www.w3.org/2001/XMLSchema#"
+#define TURTLE_ATOM_PREFIX "http://lv2plug.in/ns/ext/atom#"
+
+/*
+ * Minimal Turtle reader for LV2 presets and saved plugin states (as
+ * written by lilv): Prefixes, IRIs, prefixed names, (long) string and
+ * numeric literals, blank nodes and collections. Enough to extract port
+ * values (lv2:port) and state properties (state:state) without an RDF
+ * library.
+ */
+class TurtleState
+{
+public:
+	struct Node
+	{
+		enum Kind {IRI, LITERAL, BLANK, LIST} kind;
+		std::string value;
+		std::string datatype;
+		std::vector<std::pair<std::string, Node>> properties;
+		std::vector<Node> items;
+
+		Node () : kind (LITERAL), value (), datatype (), properties (), items () {}
+
+		const Node* get (const std::string& predicate) const
+		{
+			for (const std::pair<std::string, Node>& p : properties)
+			{
+				if (p.first == predicate) return &p.second;
+			}
+			return nullptr;
+		}
+	};
+
+	TurtleState () : subjects (), text (), pos (0), prefixes () {}
+
+	void load (const std::string& filename)
+	{
+		std::ifstream file (filename);
+		if (!file.good()) throw std::invalid_argument ("Can't open " + filename + ".");
+		std::stringstream buffer;
+		buffer << file.rdbuf();
+		parse (buffer.str());
+	}
+
+	void parse (const std::string& turtle)
+	{
+		text = turtle;
+		pos = 0;
+		subjects.clear();
+		prefixes.clear();
+
+		while (skipSpace ())
+		{
+			if (text.compare (pos, 7, "@prefix") == 0)
+			{
+				pos += 7;
+				skipSpace ();
+				const size_t colon = text.find (':', pos);
+				if (colon == std::string::npos) fail ("Invalid prefix");
+				const std::string name = trim (text.substr (pos, colon - pos));
+				pos = colon + 1;
+				skipSpace ();
+				prefixes[name] = readIri ();
+				expect ('.');
+			}
+
+			else
+			{
+				Node subject;
+				if (peek () == '[') subject = readBlank ();
+				else
+				{
+					subject.kind = Node::IRI;
+					subject.value = readName ();
+				}
+
+				if (peek () != '.') readProperties (subject);
+				expect ('.');
+				subjects.push_back (subject);
+			}
+		}
+	}
+
+	/*
+	 * Port values by port symbol (lv2:port [lv2:symbol ...; pset:value ...]).
+	 */
+	std::map<std::string, double> getPortValues () const
+	{
+		std::map<std::string, double> values;
+		for (const Node& s : subjects)
+		{
+			for (const std::pair<std::string, Node>& p : s.properties)
+			{
+				if (p.first != TURTLE_LV2_PORT) continue;
+				const Node* symbol = p.second.get (TURTLE_LV2_SYMBOL);
+				const Node* value = p.second.get (TURTLE_PSET_VALUE);
+				if (symbol && value) values[symbol->value] = atof (value->value.c_str());
+			}
+		}
+		return values;
+	}
+
+	/*
+	 * Properties of the state:state node.
+	 */
+	const Node* getState () const
+	{
+		for (const Node& s : subjects)
+		{
+			const Node* state = s.get (TURTLE_STATE_STATE);
+			if (state) return state;
+		}
+		return nullptr;
+	}
+
+	std::vector<Node> subjects;
+
+protected:
+	std::string text;
+	size_t pos;
+	std::map<std::string, std::string> prefixes;
+
+	void fail (const std::string& msg) const
+	{
+		size_t line = 1;
+		for (size_t i = 0; (i < pos) && (i < text.size()); ++i) if (text[i] == '\n') ++line;
+		throw std::invalid_argument (msg + " in line " + std::to_string (line) + ".");
+	}
+
+	static std::string trim (const std::string& s)
+	{
+		const size_t b = s.find_first_not_of (" \t\r\n");
+		if (b == std::string::npos) return "";
+		return s.substr (b, s.find_last_not_of (" \t\r\n") - b + 1);
+	}
+
+	// Skips white space and comments. Returns false at the end of text.
+	bool skipSpace ()
+	{
+		while (pos < text.size())
+		{
+			if (isspace ((unsigned char) text[pos])) ++pos;
+			else if (text[pos] == '#')
+			{
+				while ((pos < text.size()) && (text[pos] != '\n')) ++pos;
+			}
+			else return true;
+		}
+		return false;
+	}
+
+	char peek ()
+	{
+		if (!skipSpace ()) fail ("Unexpected end of file");
+		return text[pos];
+	}
+
+	void expect (const char c)
+	{
+		if (peek () != c) fail (std::string ("'") + c + "' expected");
+		++pos;
+	}
+
+	std::string readIri ()
+	{
+		expect ('<');
+		const size_t end = text.find ('>', pos);
+		if (end == std::string::npos) fail ("Unterminated IRI");
+		const std::string iri = text.substr (pos, end - pos);
+		pos = end + 1;
+		return iri;
+	}
+
+	// IRI or prefixed name, expanded
+	std::string readName ()
+	{
+		if (peek () == '<') return readIri ();
+
+		const size_t start = pos;
+		while ((pos < text.size()) && (!isspace ((unsigned char) text[pos])) && (std::string (",;[]()").find (text[pos]) == std::string::npos))
+		{
+			++pos;
+		}
+
+		// Don't take a final dot as part of the name
+		if ((pos > start + 1) && (text[pos - 1] == '.')) --pos;
+		const std::string name = text.substr (start, pos - start);
+
+		if (name == "a") return TURTLE_RDF_TYPE;
+		const size_t colon = name.find (':');
+		if (colon == std::string::npos) fail ("Invalid name " + name);
+		std::map<std::string, std::string>::const_iterator it = prefixes.find (name.substr (0, colon));
+		if (it == prefixes.end()) fail ("Unknown prefix in " + name);
+		return it->second + name.substr (colon + 1);
+	}
+
+	std::string readString ()
+	{
+		const char q = text[pos];
+		const bool isLong = (text.compare (pos, 3, std::string (3, q)) == 0);
+		pos += (isLong ? 3 : 1);
+
+		std::string s;
+		while (pos < text.size())
+		{
+			if (isLong ? (text.compare (pos, 3, std::string (3, q)) == 0) : (text[pos] == q))
+			{
+				pos += (isLong ? 3 : 1);
+				return s;
+			}
+
+			if ((text[pos] == '\\') && (pos + 1 < text.size()))
+			{
+				++pos;
+				switch (text[pos])
+				{
+					case 'n':	s += '\n'; break;
+					case 'r':	s += '\r'; break;
+					case 't':	s += '\t'; break;
+					default:	s += text[pos];
+				}
+			}
+			else s += text[pos];
+			++pos;
+		}
+
+		fail ("Unterminated string");
+		return s;
+	}
+
+	Node readObject ()
+	{
+		Node node;
+		const char c = peek ();
+
+		if (c == '[') return readBlank ();
+
+		if (c == '(')
+		{
+			++pos;
+			node.kind = Node::LIST;
+			while (peek () != ')') node.items.push_back (readObject ());
+			++pos;
+			return node;
+		}
+
+		if ((c == '"') || (c == '\''))
+		{
+			node.kind = Node::LITERAL;
+			node.value = readString ();
+			node.datatype = TURTLE_XSD_PREFIX "string";
+			if (text.compare (pos, 2, "^^") == 0)
+			{
+				pos += 2;
+				node.datatype = readName ();
+			}
+			else if ((pos < text.size()) && (text[pos] == '@'))
+			{
+				while ((pos < text.size()) && (!isspace ((unsigned char) text[pos])) && (text[pos] != ';') && (text[pos] != ',')) ++pos;
+			}
+			return node;
+		}
+
+		if ((c == '-') || (c == '+') || (c == '.') || isdigit ((unsigned char) c))
+		{
+			const size_t start = pos;
+			while ((pos < text.size()) && (isdigit ((unsigned char) text[pos]) || (std::string ("+-.eE").find (text[pos]) != std::string::npos)))
+			{
+				++pos;
+			}
+			if ((pos > start + 1) && (text[pos - 1] == '.')) --pos;
+			node.kind = Node::LITERAL;
+			node.value = text.substr (start, pos - start);
+			node.datatype = (node.value.find_first_of (".eE") == std::string::npos ? TURTLE_XSD_PREFIX "integer" : TURTLE_XSD_PREFIX "decimal");
+			return node;
+		}
+
+		if ((text.compare (pos, 4, "true") == 0) || (text.compare (pos, 5, "false") == 0))
+		{
+			node.kind = Node::LITERAL;
+			node.value = (text[pos] == 't' ? "true" : "false");
+			node.datatype = TURTLE_XSD_PREFIX "boolean";
+			pos += node.value.size();
+			return node;
+		}
+
+		node.kind = Node::IRI;
+		node.value = readName ();
+		return node;
+	}
+
+	Node readBlank ()
+	{
+		Node node;
+		node.kind = Node::BLANK;
+		expect ('[');
+		if (peek () != ']') readProperties (node);
+		expect (']');
+		return node;
+	}
+
+	void readProperties (Node& node)
+	{
+		while (true)
+		{
+			const std::string predicate = readName ();
+			while (true)
+			{
+				node.properties.push_back (std::make_pair (predicate, readObject ()));
+				if (peek () != ',') break;
+				++pos;
+			}
+
+			if (peek () != ';') return;
+			while (peek () == ';') ++pos;
+			if ((peek () == '.') || (peek () == ']')) return;
+		}
+	}
+};
+
+#endif /* TURTLESTATE_HPP_ */
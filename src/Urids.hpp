@@ -85,6 +85,8 @@ struct BOopsURIDs
 	LV2_URID bOops_sampleLoop;
 	LV2_URID bOops_installSample;
 	LV2_URID bOops_sampleFreeEvent;
+	LV2_URID bOops_installState;
+	LV2_URID bOops_freeState;
 	LV2_URID bOops_pagePropertiesEvent;
 	LV2_URID bOops_pageID;
 	LV2_URID bOops_pageMax;
@@ -97,6 +99,8 @@ struct BOopsURIDs
 	LV2_URID bOops_midiLearned;
 	LV2_URID bOops_editorPage;
 	LV2_URID bOops_editorSlot;
+	LV2_URID bOops_seed;
+	LV2_URID bOops_forceMono;
 };
 
 #endif /* URIDS_HPP_ */
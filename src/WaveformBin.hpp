@@ -0,0 +1,91 @@
+/* B.Oops
+ * Glitch effect sequencer LV2 plugin
+ *
+ * Copyright (C) 2020 by Sven Jähnichen
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef WAVEFORMBIN_HPP_
+#define WAVEFORMBIN_HPP_
+
+#include <cmath>
+#include <cstdint>
+
+#define WAVEFORM_RANGE 2.0f
+#define WAVEFORM_RESOLUTION 0x3FF
+
+/*
+ * Waveform display bin: min / max peak pair and RMS of all samples within
+ * the bin. Packed into a single 32 bit integer (3 x 10 bit) for transfer to
+ * the GUI.
+ */
+struct WaveformBin
+{
+	float min;
+	float max;
+	float rms;
+};
+
+struct WaveformAccumulator
+{
+	float min;
+	float max;
+	float sumsq;
+	uint32_t count;
+
+	void reset (const float value)
+	{
+		min = value;
+		max = value;
+		sumsq = value * value;
+		count = 1;
+	}
+
+	void add (const float value)
+	{
+		if (value < min) min = value;
+		if (value > max) max = value;
+		sumsq += value * value;
+		++count;
+	}
+
+	WaveformBin get () const {return {min, max, (count ? sqrtf (sumsq / count) : 0.0f)};}
+};
+
+inline int32_t quantizeWaveformValue (const float value)
+{
+	const int32_t q = lrintf ((value / WAVEFORM_RANGE + 1.0f) * 0.5f * WAVEFORM_RESOLUTION);
+	return (q < 0 ? 0 : (q > WAVEFORM_RESOLUTION ? WAVEFORM_RESOLUTION : q));
+}
+
+inline float dequantizeWaveformValue (const int32_t q) {return (2.0f * float (q) / WAVEFORM_RESOLUTION - 1.0f) * WAVEFORM_RANGE;}
+
+inline int32_t packWaveformBin (const WaveformBin& bin)
+{
+	return quantizeWaveformValue (bin.min) | (quantizeWaveformValue (bin.max) << 10) | (quantizeWaveformValue (bin.rms) << 20);
+}
+
+inline WaveformBin unpackWaveformBin (const int32_t packed)
+{
+	return
+	{
+		dequantizeWaveformValue (packed & WAVEFORM_RESOLUTION),
+		dequantizeWaveformValue ((packed >> 10) & WAVEFORM_RESOLUTION),
+		dequantizeWaveformValue ((packed >> 20) & WAVEFORM_RESOLUTION)
+	};
+}
+
+#endif /* WAVEFORMBIN_HPP_ */
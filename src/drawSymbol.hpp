@@ -23,6 +23,7 @@
 
 #include "BWidgets/cairoplus.h"
 #include "BWidgets/BColors.hpp"
+#include "GlyphCache.hpp"
 #include <cmath>
 
 #ifdef LOCALEFILE
@@ -61,7 +62,7 @@ const std::string symboltxt[11] =
         BOOPS_LABEL_SHAPE_PATTERN
 };
 
-void drawSymbol (cairo_t* cr, const double x0, const double y0, const double w, const double h, const BColors::Color& color, SymbolIndex symbol = NOSYMBOL)
+void renderSymbol (cairo_t* cr, const double x0, const double y0, const double w, const double h, const BColors::Color& color, SymbolIndex symbol = NOSYMBOL)
 {
 	if ((w <= 0) || (h <= 0)) return;
 
@@ -172,6 +173,19 @@ void drawSymbol (cairo_t* cr, const double x0, const double y0, const double w,
         }
 }
 
+void drawSymbol (cairo_t* cr, const double x0, const double y0, const double w, const double h, const BColors::Color& color, SymbolIndex symbol = NOSYMBOL)
+{
+	if ((w <= 0) || (h <= 0) || (symbol == NOSYMBOL)) return;
+
+	getGlyphCache().draw
+	(
+		cr, symbol, x0, y0, w, h, color,
+		[&color, symbol] (cairo_t* gcr, const double x, const double y, const double gw, const double gh)
+		{renderSymbol (gcr, x, y, gw, gh, color, symbol);}
+	);
+	cairo_set_source_rgba (cr, CAIRO_RGBA (color));
+}
+
 void drawSymbol (cairo_surface_t* surface, const double x, const double y, const double width, const double height, const BColors::Color& color, SymbolIndex symbol = NOSYMBOL)
 {
 	cairo_t* cr = cairo_create (surface);
@@ -3,9 +3,12 @@
 
 #include "BWidgets/cairoplus.h"
 #include "BWidgets/BColors.hpp"
+#include "GlyphCache.hpp"
 #include <cmath>
 
-void drawButton (cairo_t* cr, double x, double y, double width, double height, BColors::Color color)
+#define BUTTONGLYPH -2
+
+void renderButton (cairo_t* cr, double x, double y, double width, double height, BColors::Color color)
 {
 	if ((width <= 0) || (height <= 0)) return;
 
@@ -24,6 +27,18 @@ void drawButton (cairo_t* cr, double x, double y, double width, double height, B
 	cairo_pattern_destroy (pat);
 }
 
+void drawButton (cairo_t* cr, double x, double y, double width, double height, BColors::Color color)
+{
+	if ((width <= 0) || (height <= 0)) return;
+
+	getGlyphCache().draw
+	(
+		cr, BUTTONGLYPH, x, y, width, height, color,
+		[&color] (cairo_t* gcr, const double gx, const double gy, const double gw, const double gh)
+		{renderButton (gcr, gx, gy, gw, gh, color);}
+	);
+}
+
 void drawButton (cairo_surface_t* surface, double x, double y, double width, double height, BColors::Color color)
 {
 	cairo_t* cr = cairo_create (surface);
@@ -85,6 +85,8 @@ void getURIs (LV2_URID_Map* m, BOopsURIDs* uris)
 	uris->bOops_sampleLoop = m->map(m->handle, BOOPS_URI "#sampleLoop");
 	uris->bOops_installSample = m->map(m->handle, BOOPS_URI "#installSample");
 	uris->bOops_sampleFreeEvent = m->map(m->handle, BOOPS_URI "#sampleFreeEvent");
+	uris->bOops_installState = m->map(m->handle, BOOPS_URI "#installState");
+	uris->bOops_freeState = m->map(m->handle, BOOPS_URI "#freeState");
 	uris->bOops_pagePropertiesEvent = m->map(m->handle, BOOPS_URI "#pagePropertiesEvent");
 	uris->bOops_pageID = m->map(m->handle, BOOPS_URI "#pageID");
 	uris->bOops_pageMax = m->map(m->handle, BOOPS_URI "#pageMax");
@@ -97,6 +99,8 @@ void getURIs (LV2_URID_Map* m, BOopsURIDs* uris)
 	uris->bOops_midiLearned = m->map(m->handle, BOOPS_URI "#midiLearned");
 	uris->bOops_editorPage = m->map(m->handle, BOOPS_URI "#editorPage");
 	uris->bOops_editorSlot = m->map(m->handle, BOOPS_URI "#editorSlot");
+	uris->bOops_seed = m->map(m->handle, BOOPS_URI "#seed");
+	uris->bOops_forceMono = m->map(m->handle, BOOPS_URI "#forceMono");
 }
 
 #endif /* GETURIS_HPP_ */